@@ -2,6 +2,15 @@
 
 #include <CSCI441/objects.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <random>
+#include <thread>
+
 //*************************************************************************************
 //
 // Helper Functions
@@ -10,14 +19,52 @@
 #define M_PI 3.14159265f
 #endif
 
+/// \desc vertex and fragment shader of the lighting shader
+static const char* const LIGHTING_SHADER_FILES[] = { "shaders/A3.v.glsl", "shaders/A3.f.glsl" };
+/// \desc macro each LightingFeature defines in the lighting shader, in bit order
+static const char* const LIGHTING_FEATURE_DEFINES[] = { "POINT_LIGHTS" };
+/// \desc shader files of the text overlay
+static const char* const OVERLAY_SHADER_FILES[] = { "shaders/text.v.glsl", "shaders/text.f.glsl" };
+/// \desc most the late latch turns the camera past its snapshot on either axis, in radians
+static constexpr GLfloat LATE_LATCH_MAX_TURN = 0.1f;
+/// \desc most the late latch zooms the camera past its snapshot, in world units
+static constexpr GLfloat LATE_LATCH_MAX_ZOOM = 1.0f;
+
+#ifdef A3_ENABLE_PROFILER
+/// \desc records every job the job system runs as a profiler zone on the thread that ran it
+static void profileJob(const char* name, const int workerIndex,
+                       const std::chrono::steady_clock::time_point start, const std::chrono::steady_clock::time_point end) {
+    if( workerIndex >= 0 ) Profiler::setThreadName("job worker", workerIndex);
+    Profiler::record(name, Profiler::toProfilerTime(start), Profiler::toProfilerTime(end));
+}
+#endif
+
+/// \desc computes the min, average and 99th percentile of a list of frame times
+/// \param times frame times, sorted in place
+/// \param stats filled with the min, average and 99th percentile, all zero for an empty list
+static void computeFrameTimeStats(std::vector<GLdouble>& times, GLdouble stats[3]) {
+    stats[0] = stats[1] = stats[2] = 0.0;
+    if( times.empty() ) return;
+
+    std::sort( times.begin(), times.end() );
+    stats[0] = times.front();
+    for(GLdouble time : times) stats[1] += time;
+    stats[1] /= (GLdouble)times.size();
+    stats[2] = times[ (size_t)glm::ceil(0.99 * (GLdouble)times.size()) - 1 ];
+}
+
 //*************************************************************************************
 //
 // Public Interface
 
-A3Engine::A3Engine()
+A3Engine::A3Engine(const Settings& settings)
          : CSCI441::OpenGLEngine(4, 1,
                                  640, 480,
-                                 "A3: The Cabin In The Woods") {
+                                 "A3: The Cabin In The Woods"),
+           _settings(settings) {
+
+    // named before setup records its first zones so the startup breakdown lands on the main thread's track
+    Profiler::setThreadName("main");
 
     for(auto& _key : _keys) _key = GL_FALSE;
 
@@ -26,18 +73,100 @@ A3Engine::A3Engine()
     _yOffset = 0.1;
     _timeVariable = 0.0;
     _hoverAmount = 0.0;
+    _simulationAccumulator = 0.0;
+    _simulationTick = 0;
+    _isSceneDirty = GL_TRUE;
+    _snapshotNumber = 0;
+    _lateView = {0.0f, 0.0f, 0.0f, 0};
+    _numLatchedFrames = 0;
+    _numLateViewsUsed = 0;
+    _previousState = _currentState = _renderState = {heroPosition, 0.0f};
     _mousePosition = glm::vec2(MOUSE_UNINITIALIZED, MOUSE_UNINITIALIZED );
     _leftMouseButtonState = GLFW_RELEASE;
+    _pendingCameraInput = {0.0f, 0.0f, 0};
+    _isRawMouseMotionEnabled = false;
+
+    _pFrameResources = nullptr;
+    _pSceneTarget = nullptr;
+    _pGpuProfiler = nullptr;
+    _pTextOverlay = nullptr;
+    _pShaderHotReloader = nullptr;
+    _isStatsOverlayVisible = _settings.statsOverlay;
+
+    // an endpoint for a monitoring agent is no use without reports, fall back to a sensible period
+    if( !_settings.telemetryOutput.empty() && _settings.telemetryInterval <= 0.0 ) {
+        _settings.telemetryInterval = 5.0;
+    }
+    _isTelemetryEnabled = _settings.telemetryInterval > 0.0;
+    _frameTelemetry.setReportInterval(_settings.telemetryInterval);
+    _frameTelemetry.setOutputPath(_settings.telemetryOutput.c_str());
+    _pArcballCam = nullptr;
+    _isReverseZEnabled = GL_FALSE;
+    _framebufferSize = glm::ivec2(0, 0);
+
+    _pJobSystem = new JobSystem(_settings.workerThreads);
+
+    if( !_settings.profileOutput.empty() ) {
+#ifdef A3_ENABLE_PROFILER
+        Profiler::setEnabled(true);
+        _pJobSystem->setTimingCallback(profileJob);
+#else
+        fprintf( stderr, "[WARN]: Built without A3_ENABLE_PROFILER, no profile will be written\n" );
+#endif
+    }
+#ifndef A3_ENABLE_PROFILER
+    if( _settings.gpuProfile ) {
+        fprintf( stderr, "[WARN]: Built without A3_ENABLE_PROFILER, the GPU will not be profiled\n" );
+    }
+#endif
+
+    // a replay runs in the world and at the rate it was recorded with
+    if( !_settings.replayInput.empty() && _inputReplayer.load(_settings.replayInput.c_str()) ) {
+        _settings.worldSeed = _inputReplayer.getWorldSeed();
+        _settings.simulationRate = _inputReplayer.getSimulationRate();
+    }
+    if( _settings.worldSeed == 0 ) {
+        _settings.worldSeed = (GLuint)time(nullptr);
+    }
+    if( !_settings.recordInput.empty() && !_inputReplayer.isLoaded() ) {
+        _inputRecorder.open(_settings.recordInput.c_str(), _settings.worldSeed, _settings.simulationRate);
+    }
+
+    // a scripted benchmark is always timed headless, for exactly as many frames as the script lasts
+    if( !_settings.benchmarkScript.empty() && _benchmarkScript.load(_settings.benchmarkScript.c_str()) ) {
+        _settings.headless = true;
+        _settings.benchmarkFrames = (GLuint)glm::ceil( _benchmarkScript.getDuration() * _settings.simulationRate );
+    }
+
+    // only the lighting variant the scene uses is ever compiled
+    _pLightingShaders = new CSCI441::ShaderPermutationCache(LIGHTING_SHADER_FILES[0], LIGHTING_SHADER_FILES[1],
+                                                            {std::begin(LIGHTING_FEATURE_DEFINES), std::end(LIGHTING_FEATURE_DEFINES)});
+    _lightingFeatures = 0;
+    if( _settings.stress.numLights > 0 ) _lightingFeatures |= LIGHTING_POINT_LIGHTS;
+
+    // everything the world needs is known now, so build it while the window and context come up
+    _runStartTime = 0;
+    _firstFrameTime = 0;
+    _isStartupReported = false;
+    _startBackgroundSetup();
 }
 
 A3Engine::~A3Engine() {
+    // setup may have failed before the background jobs were waited on
+    _pJobSystem->wait(_backgroundSetupJobs);
     delete _pArcballCam;
+    delete _pLightingShaders;
+    delete _pJobSystem;
 }
 
 void A3Engine::handleKeyEvent(GLint key, GLint action) {
+    _inputRecorder.record({_simulationTick, InputEvent::Type::KEY, key, action, glm::vec2(0.0f)});
+
     if(key != GLFW_KEY_UNKNOWN)
         _keys[key] = ((action == GLFW_PRESS) || (action == GLFW_REPEAT));
 
+    _isSceneDirty = GL_TRUE;
+
     if(action == GLFW_PRESS ) {
         switch( key ) {
             // quit!
@@ -46,20 +175,39 @@ void A3Engine::handleKeyEvent(GLint key, GLint action) {
                 setWindowShouldClose();
                 break;
 
+            // show or hide the render stats
+            case GLFW_KEY_F3:
+                _isStatsOverlayVisible = !_isStatsOverlayVisible;
+                break;
+
+            // dump everything profiled so far
+            case GLFW_KEY_F9:
+                if( Profiler::isEnabled() ) Profiler::writeChromeTrace(_settings.profileOutput.c_str());
+                break;
+
             default: break; // suppress CLion warning
         }
     }
 }
 
 void A3Engine::handleMouseButtonEvent(GLint button, GLint action) {
+    _inputRecorder.record({_simulationTick, InputEvent::Type::MOUSE_BUTTON, button, action, glm::vec2(0.0f)});
+
     // if the event is for the left mouse button
     if( button == GLFW_MOUSE_BUTTON_LEFT ) {
         // update the left mouse button's state
         _leftMouseButtonState = action;
+
+        // raw motion is only delivered while the cursor is captured, so capture it while dragging
+        if( _isRawMouseMotionEnabled ) {
+            glfwSetInputMode(mpWindow, GLFW_CURSOR, action == GLFW_PRESS ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+        }
     }
 }
 
 void A3Engine::handleCursorPositionEvent(glm::vec2 currMousePosition) {
+    _inputRecorder.record({_simulationTick, InputEvent::Type::CURSOR_POSITION, 0, 0, currMousePosition});
+
     // if mouse hasn't moved in the window, prevent camera from flipping out
     if(_mousePosition.x == MOUSE_UNINITIALIZED) {
         _mousePosition = currMousePosition;
@@ -68,77 +216,246 @@ void A3Engine::handleCursorPositionEvent(glm::vec2 currMousePosition) {
     // Creates the zoom in and out feature for the ArcballCam.
     if(_leftMouseButtonState == GLFW_PRESS && _keys[GLFW_KEY_LEFT_SHIFT] || _keys[GLFW_KEY_RIGHT_SHIFT] ) {
         if(currMousePosition.y > _mousePosition.y) {
-            _pArcballCam->moveForward(_cameraSpeed.x);
+            _pendingCameraInput.zoomSteps++;
         }
         if(currMousePosition.y < _mousePosition.y) {
-            _pArcballCam->moveBackward(_cameraSpeed.x);
+            _pendingCameraInput.zoomSteps--;
         }
     }
 
     // if the left mouse button is being held down while the mouse is moving
     if(_leftMouseButtonState == GLFW_PRESS) {
         // rotate the camera by the distance the mouse moved
-        _pArcballCam->rotate((currMousePosition.x - _mousePosition.x) * 0.005f,
-                         (_mousePosition.y - currMousePosition.y) * 0.005f );
+        _pendingCameraInput.dTheta += (currMousePosition.x - _mousePosition.x) * 0.005f;
+        _pendingCameraInput.dPhi   += (_mousePosition.y - currMousePosition.y) * 0.005f;
     }
 
     // update the mouse position
     _mousePosition = currMousePosition;
 }
 
+void A3Engine::handleFramebufferSizeEvent(GLint width, GLint height) {
+    _framebufferSize = glm::ivec2(width, height);
+
+    // a minimized window reports a zero size, keep the last usable aspect ratio
+    if(width > 0 && height > 0 && _pArcballCam != nullptr) {
+        _pArcballCam->setAspectRatio( (GLfloat)width / (GLfloat)height );
+    }
+
+    _isSceneDirty = GL_TRUE;
+}
+
+void A3Engine::handleWindowRefreshEvent() {
+    _isSceneDirty = GL_TRUE;
+}
+
+void A3Engine::_applyCameraInput() {
+    A3_PROFILE_FUNCTION();
+
+    // the camera is only touched once per frame no matter how many cursor events arrived
+    if(_pendingCameraInput.zoomSteps > 0) {
+        _pArcballCam->moveForward(_cameraSpeed.x * (GLfloat)_pendingCameraInput.zoomSteps);
+    } else if(_pendingCameraInput.zoomSteps < 0) {
+        _pArcballCam->moveBackward(_cameraSpeed.x * (GLfloat)-_pendingCameraInput.zoomSteps);
+    }
+
+    if(_pendingCameraInput.dTheta != 0.0f || _pendingCameraInput.dPhi != 0.0f) {
+        _pArcballCam->rotate(_pendingCameraInput.dTheta, _pendingCameraInput.dPhi);
+    }
+
+    if(_pendingCameraInput.zoomSteps != 0 || _pendingCameraInput.dTheta != 0.0f || _pendingCameraInput.dPhi != 0.0f) {
+        _isSceneDirty = GL_TRUE;
+    }
+
+    _pendingCameraInput = {0.0f, 0.0f, 0};
+}
+
 //*************************************************************************************
 //
 // Engine Setup
 
 void A3Engine::mSetupGLFW() {
+    const int64_t phaseStart = Profiler::now();
+    A3_PROFILE_FUNCTION();
+
+    if( _settings.headless ) {
+        // window hints need an initialized library, the base class initializing it again is harmless
+        GLboolean isNullPlatform = GL_FALSE;
+        if( !glfwInit() ) {
+#ifdef GLFW_PLATFORM_NULL
+            // no display to connect to, fall back to a window-less platform with an EGL context
+            fprintf( stderr, "[WARN]: No display available, using the null platform\n" );
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+            isNullPlatform = glfwInit() ? GL_TRUE : GL_FALSE;
+#endif
+        }
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        if( isNullPlatform ) {
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        }
+    }
+
     CSCI441::OpenGLEngine::mSetupGLFW();
 
-    // set our callbacks
-    glfwSetKeyCallback(mpWindow, lab05_engine_keyboard_callback);
-    glfwSetMouseButtonCallback(mpWindow, lab05_engine_mouse_button_callback);
-    glfwSetCursorPosCallback(mpWindow, lab05_engine_cursor_callback);
+    // set our callbacks, a replay takes its input from the recording instead
+    if( _inputReplayer.isLoaded() ) {
+        fprintf( stdout, "[INFO]: Live input is ignored while replaying\n" );
+    } else {
+        glfwSetKeyCallback(mpWindow, lab05_engine_keyboard_callback);
+        glfwSetMouseButtonCallback(mpWindow, lab05_engine_mouse_button_callback);
+        glfwSetCursorPosCallback(mpWindow, lab05_engine_cursor_callback);
+    }
+    glfwSetFramebufferSizeCallback(mpWindow, lab05_engine_framebuffer_size_callback);
+    glfwSetWindowRefreshCallback(mpWindow, lab05_engine_window_refresh_callback);
+
+    // unaccelerated, unscaled motion straight from the device if the platform offers it
+    if( _settings.rawMouseMotion ) {
+        if( glfwRawMouseMotionSupported() ) {
+            glfwSetInputMode(mpWindow, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+            _isRawMouseMotionEnabled = true;
+        } else {
+            fprintf( stderr, "[WARN]: Raw mouse motion is not supported on this platform\n" );
+        }
+    }
+
+    _endStartupPhase( "setupGLFW", phaseStart );
 }
 
 void A3Engine::mSetupOpenGL() {
+    const int64_t phaseStart = Profiler::now();
+    A3_PROFILE_FUNCTION();
+
+    // reversed-Z only pays off with a [0,1] clip depth range, which needs clip control
+    _isReverseZEnabled = GL_FALSE;
+    if( _settings.reverseZ ) {
+        if( GLEW_VERSION_4_5 || GLEW_ARB_clip_control ) {
+            glClipControl( GL_LOWER_LEFT, GL_ZERO_TO_ONE );
+            _isReverseZEnabled = GL_TRUE;
+        } else {
+            fprintf( stderr, "[WARN]: glClipControl is not available, using standard depth\n" );
+        }
+    }
+
     glEnable( GL_DEPTH_TEST );					                        // enable depth testing
-    glDepthFunc( GL_LESS );							                // use less than depth test
+    if( _isReverseZEnabled ) {
+        glDepthFunc( GL_GREATER );                                      // near is 1 and infinity is 0
+        glClearDepth( 0.0 );                                            // clear to infinitely far away
+    } else {
+        glDepthFunc( GL_LESS );							            // use less than depth test
+    }
 
     glEnable(GL_BLEND);									            // enable blending
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);	    // use one minus blending equation
 
     glClearColor( 0.0f, 0.0f, 0.0f, 1.0f );	        // clear the frame buffer to black
+
+    _endStartupPhase( "setupOpenGL", phaseStart );
 }
 
 void A3Engine::mSetupShaders() {
-    _lightingShaderProgram = new CSCI441::ShaderProgram("shaders/A3.v.glsl", "shaders/A3.f.glsl" );
+    const int64_t phaseStart = Profiler::now();
+    A3_PROFILE_FUNCTION();
+
+    // count the uniforms every shader program uploads from here on
+    RenderStats::install();
+
+    _lightingShaderProgram = _pLightingShaders->getProgram( _lightingFeatures );
+    _lookupLightingShaderUniforms();
+
+    _lightingShaderAttributeLocations.vPos         = _lightingShaderProgram->getAttributeLocation("vPos");
+    // TODO #3B: assign attributes
+    _lightingShaderAttributeLocations.vertexNormal = _lightingShaderProgram->getAttributeLocation("vertexNormal");
+
+    // a benchmark measures the shaders it started with
+    if( _settings.shaderHotReload && !_settings.headless ) {
+        _pShaderHotReloader = new ShaderHotReloader();
+        _pShaderHotReloader->addProgram(LIGHTING_SHADER_FILES[0], LIGHTING_SHADER_FILES[1], _pLightingShaders->getDefines(_lightingFeatures),
+                                        [this](CSCI441::ShaderProgram* pShaderProgram) { _swapLightingShaderProgram(pShaderProgram); });
+        if( !_pShaderHotReloader->start(mpWindow) ) {
+            delete _pShaderHotReloader;
+            _pShaderHotReloader = nullptr;
+        }
+    }
+
+    _endStartupPhase( "setupShaders", phaseStart );
+}
+
+void A3Engine::_lookupLightingShaderUniforms() {
     _lightingShaderUniformLocations.mvpMatrix      = _lightingShaderProgram->getUniformLocation("mvpMatrix");
     _lightingShaderUniformLocations.materialColor  = _lightingShaderProgram->getUniformLocation("materialColor");
     // TODO #3A: assign uniforms
     _lightingShaderUniformLocations.normalMatrix = _lightingShaderProgram->getUniformLocation("normalMatrix");
     _lightingShaderUniformLocations.lightDirection = _lightingShaderProgram->getUniformLocation("lightDirection");
     _lightingShaderUniformLocations.lightColor = _lightingShaderProgram->getUniformLocation("lightColor");
-
-    _lightingShaderAttributeLocations.vPos         = _lightingShaderProgram->getAttributeLocation("vPos");
-    // TODO #3B: assign attributes
-    _lightingShaderAttributeLocations.vertexNormal = _lightingShaderProgram->getAttributeLocation("vertexNormal");
-
+    if( _lightingFeatures & LIGHTING_POINT_LIGHTS ) {
+        _lightingShaderUniformLocations.modelMatrix = _lightingShaderProgram->getUniformLocation("modelMatrix");
+        _lightingShaderUniformLocations.numPointLights = _lightingShaderProgram->getUniformLocation("numPointLights");
+        _lightingShaderUniformLocations.pointLightPositions = _lightingShaderProgram->getUniformLocation("pointLightPositions");
+        _lightingShaderUniformLocations.pointLightColors = _lightingShaderProgram->getUniformLocation("pointLightColors");
+    } else {
+        // compiled out of this variant, uploads to -1 are ignored
+        _lightingShaderUniformLocations.modelMatrix = -1;
+        _lightingShaderUniformLocations.numPointLights = -1;
+        _lightingShaderUniformLocations.pointLightPositions = -1;
+        _lightingShaderUniformLocations.pointLightColors = -1;
+    }
 }
 
 void A3Engine::mSetupBuffers() {
+    const int64_t phaseStart = Profiler::now();
+    A3_PROFILE_FUNCTION();
+
     // TODO #4: need to connect our 3D Object Library to our shader
     CSCI441::setVertexAttributeLocations( _lightingShaderAttributeLocations.vPos, _lightingShaderAttributeLocations.vertexNormal );
 
     // TODO #5: give the hero the normal matrix location
     _pHero = new Hero(_lightingShaderProgram->getShaderProgramHandle(),
                       _lightingShaderUniformLocations.mvpMatrix,
+                      _lightingShaderUniformLocations.modelMatrix,
                       _lightingShaderUniformLocations.normalMatrix,
                       _lightingShaderUniformLocations.materialColor);
 
     _createGroundBuffers();
-    _generateEnvironment();
+    // the tiles, heroes and lights have been generated on the workers since launch
+    _finishBackgroundSetup();
+
+    _pFrameResources = new FrameResources(_settings.framesInFlight, _settings.transientBufferSize);
+
+#ifdef A3_ENABLE_PROFILER
+    // read back one frame later than the fences allow, so the queries are all but certain to be done
+    if( _settings.gpuProfile || Profiler::isEnabled() ) {
+        _pGpuProfiler = new GpuProfiler(_pFrameResources->getNumFramesInFlight() + 1);
+    }
+#endif
+
+    // the default framebuffer only has fixed point depth, reversed-Z needs a float depth buffer,
+    // and a headless window may not have a usable default framebuffer at all
+    if( _isReverseZEnabled || _settings.headless ) {
+        _pSceneTarget = new RenderTarget(GL_RGBA8, _isReverseZEnabled ? GL_DEPTH_COMPONENT32F : GL_DEPTH_COMPONENT24);
+    }
+
+    // a headless run never shows the overlay
+    if( !_settings.headless ) {
+        _pTextOverlay = new TextOverlay();
+    }
+
+    if( _settings.headless ) {
+        _frameTimings.assign(_settings.benchmarkFrames, {0.0, 0.0, {}});
+    }
+    if( _settings.headless || _isTelemetryEnabled ) {
+        // the frame resources run on the render thread, as does the hook
+        _pFrameResources->setGpuTimeCallback([this](GLuint64 frameNumber, GLuint64 gpuTime) {
+            if(_isTelemetryEnabled) _frameTelemetry.record(FrameTelemetry::Metric::GPU, gpuTime);
+            if(frameNumber < _frameTimings.size()) _frameTimings[frameNumber].gpuTime = (GLdouble)gpuTime / 1000000.0;
+        });
+    }
+
+    _endStartupPhase( "setupBuffers", phaseStart );
 }
 
 void A3Engine::_createGroundBuffers() {
+    A3_PROFILE_FUNCTION();
+
     // TODO #8: expand our struct
     struct Vertex {
         GLfloat x, y, z;
@@ -177,13 +494,21 @@ void A3Engine::_createGroundBuffers() {
 }
 
 void A3Engine::_generateEnvironment() {
+    A3_PROFILE_FUNCTION();
+
+    if( _settings.stress.numTiles > 0 ) {
+        _generateStressTiles();
+        return;
+    }
+
     //******************************************************************
     // parameters to make up our grid size and spacing, feel free to
-    // play around with this
-    const GLfloat GRID_WIDTH = 100.0f;
-    const GLfloat GRID_LENGTH = 100.0f;
-    const GLfloat GRID_SPACING_WIDTH = 1.0f;
-    const GLfloat GRID_SPACING_LENGTH = 1.0f;
+    // play around with this (a benchmark script brings its own)
+    const BenchmarkScript::WorldParameters WORLD = _benchmarkScript.getWorldParameters();
+    const GLfloat GRID_WIDTH = WORLD.gridWidth;
+    const GLfloat GRID_LENGTH = WORLD.gridLength;
+    const GLfloat GRID_SPACING_WIDTH = WORLD.gridSpacing;
+    const GLfloat GRID_SPACING_LENGTH = WORLD.gridSpacing;
     // precomputed parameters based on above
     const GLfloat LEFT_END_POINT = -GRID_WIDTH / 2.0f - 5.0f;
     const GLfloat RIGHT_END_POINT = GRID_WIDTH / 2.0f + 5.0f;
@@ -191,38 +516,139 @@ void A3Engine::_generateEnvironment() {
     const GLfloat TOP_END_POINT = GRID_LENGTH / 2.0f + 5.0f;
     //******************************************************************
 
-    srand( time(0) );                                                   // seed our RNG
+    srand( _settings.worldSeed );                                       // seed our RNG, recordings keep the seed
+
+    // each row of the grid is generated by a separate job into its own list
+    const size_t NUM_ROWS = (size_t)glm::ceil( (RIGHT_END_POINT - LEFT_END_POINT) / GRID_SPACING_WIDTH );
+    std::vector< std::vector<TileData> > rows(NUM_ROWS);
 
     // psych! everything's on a grid.
-    for(int i = LEFT_END_POINT; i < RIGHT_END_POINT; i += GRID_SPACING_WIDTH) {
-        for(int j = BOTTOM_END_POINT; j < TOP_END_POINT; j += GRID_SPACING_LENGTH) {
-            // don't just draw a tiles ANYWHERE.
-            if( i % 2 && j % 2 ) {
-                // translate to spot
-                glm::mat4 transToSpotMtx = glm::translate( glm::mat4(1.0), glm::vec3(i, 0.0f, j) );
-
-                // compute height
-                GLdouble height = 0.3f;
-                // scale to tile size
-                glm::mat4 scaleToHeightMtx = glm::scale( glm::mat4(1.0), glm::vec3(1, height, 1) );
-
-                // translate up to grid
-                glm::mat4 transToHeight = glm::translate( glm::mat4(1.0), glm::vec3(0, height/2.0f, 0) );
-
-                // compute full model matrix
-                glm::mat4 modelMatrix = transToHeight * scaleToHeightMtx * transToSpotMtx;
-
-                // compute color
-                glm::vec3 color( 0.4f, 0.4f, 0.4f );
-                // store tile properties
-                TileData currentTile = {modelMatrix, color};
-                _tiles.emplace_back(currentTile );
+    _pJobSystem->parallelForAndWait("generateEnvironment", NUM_ROWS, 8, [&](size_t rowBegin, size_t rowEnd) {
+        for(size_t row = rowBegin; row < rowEnd; row++) {
+            int i = (int)(LEFT_END_POINT + (GLfloat)row * GRID_SPACING_WIDTH);
+            for(int j = BOTTOM_END_POINT; j < TOP_END_POINT; j += GRID_SPACING_LENGTH) {
+                // don't just draw a tiles ANYWHERE.
+                if( i % 2 && j % 2 ) {
+                    // compute height
+                    GLfloat height = 0.3f;
+                    // compute color
+                    glm::vec3 color( 0.4f, 0.4f, 0.4f );
+                    // store tile properties
+                    rows[row].emplace_back( _makeTile(glm::vec3(i, 0.0f, j), height, color) );
+                }
             }
         }
+    });
+
+    // stitch the rows back together in grid order
+    for(const std::vector<TileData>& row : rows) {
+        _tiles.insert(_tiles.end(), row.begin(), row.end());
     }
 }
 
+A3Engine::TileData A3Engine::_makeTile(const glm::vec3& spot, const GLfloat height, const glm::vec3& color) {
+    // translate to spot
+    glm::mat4 transToSpotMtx = glm::translate( glm::mat4(1.0), spot );
+    // scale to tile size
+    glm::mat4 scaleToHeightMtx = glm::scale( glm::mat4(1.0), glm::vec3(1, height, 1) );
+    // translate up to grid
+    glm::mat4 transToHeight = glm::translate( glm::mat4(1.0), glm::vec3(0, height/2.0f, 0) );
+
+    // compute full model matrix
+    glm::mat4 modelMatrix = transToHeight * scaleToHeightMtx * transToSpotMtx;
+
+    // bound the unit cube after it has been transformed
+    glm::vec3 boundingCenter = glm::vec3( modelMatrix[3] );
+    GLfloat boundingRadius = 0.5f * glm::sqrt( glm::dot(glm::vec3(modelMatrix[0]), glm::vec3(modelMatrix[0]))
+                                             + glm::dot(glm::vec3(modelMatrix[1]), glm::vec3(modelMatrix[1]))
+                                             + glm::dot(glm::vec3(modelMatrix[2]), glm::vec3(modelMatrix[2])) );
+    return {modelMatrix, color, boundingCenter, boundingRadius};
+}
+
+void A3Engine::_generateStressTiles() {
+    const Settings::StressScene& STRESS = _settings.stress;
+    const size_t NUM_TILES = STRESS.numTiles;
+    // spread the tiles over a square just big enough to reach the requested density
+    const GLfloat HALF_EXTENT = 0.5f * glm::sqrt( (GLfloat)NUM_TILES / glm::clamp(STRESS.density, 0.001f, 1.0f) );
+
+    // cluster centers are picked up front so every chunk agrees on them
+    std::vector<glm::vec2> clusterCenters;
+    GLfloat clusterSpread = 0.0f;
+    if( STRESS.distribution == Settings::StressScene::Distribution::CLUSTERED ) {
+        std::mt19937 rng( _settings.worldSeed );
+        std::uniform_real_distribution<GLfloat> area( -HALF_EXTENT, HALF_EXTENT );
+        const size_t NUM_CLUSTERS = glm::max( (size_t)1, (size_t)glm::sqrt((GLfloat)NUM_TILES) / 8 );
+        for(size_t i = 0; i < NUM_CLUSTERS; i++) {
+            clusterCenters.emplace_back( area(rng), area(rng) );
+        }
+        clusterSpread = HALF_EXTENT / glm::sqrt( (GLfloat)NUM_CLUSTERS ) * 0.5f;
+    }
+
+    _tiles.resize(NUM_TILES);
+    const size_t GRAIN_SIZE = 4096;
+    _pJobSystem->parallelForAndWait("generateStressTiles", NUM_TILES, GRAIN_SIZE, [&](size_t begin, size_t end) {
+        // each chunk has its own generator so the scene does not depend on which worker ran what
+        std::seed_seq seed{ _settings.worldSeed, (GLuint)(begin / GRAIN_SIZE) };
+        std::mt19937 rng( seed );
+        std::uniform_real_distribution<GLfloat> area( -HALF_EXTENT, HALF_EXTENT );
+        std::uniform_real_distribution<GLfloat> unit( 0.0f, 1.0f );
+        std::normal_distribution<GLfloat> spread( 0.0f, glm::max(clusterSpread, 0.001f) );
+
+        for(size_t i = begin; i < end; i++) {
+            glm::vec2 spot;
+            if( clusterCenters.empty() ) {
+                spot = glm::vec2( area(rng), area(rng) );
+            } else {
+                const glm::vec2& center = clusterCenters[ rng() % clusterCenters.size() ];
+                spot = glm::clamp( center + glm::vec2(spread(rng), spread(rng)), -HALF_EXTENT, HALF_EXTENT );
+            }
+
+            const GLfloat height = glm::mix( 0.1f, STRESS.maxTileHeight, unit(rng) );
+            const glm::vec3 color( glm::mix(0.2f, 1.0f, unit(rng)), glm::mix(0.2f, 1.0f, unit(rng)), glm::mix(0.2f, 1.0f, unit(rng)) );
+            // snap to whole units like the grid
+            _tiles[i] = _makeTile( glm::vec3(glm::floor(spot.x), 0.0f, glm::floor(spot.y)), height, color );
+        }
+    });
+
+    fprintf( stdout, "[INFO]: Stress scene has %zu %s tiles over %.0fx%.0f units, %.2f MB of tile data\n",
+             NUM_TILES, clusterCenters.empty() ? "uniform" : "clustered", 2.0f * HALF_EXTENT, 2.0f * HALF_EXTENT,
+             (GLdouble)(NUM_TILES * sizeof(TileData)) / (1024.0 * 1024.0) );
+}
+
+void A3Engine::_generateStressActors() {
+    const Settings::StressScene& STRESS = _settings.stress;
+    if( STRESS.numHeroes == 0 && STRESS.numLights == 0 ) return;
+
+    // heroes and lights share the tiles' area, or the grid's if there are no stress tiles
+    const GLfloat HALF_EXTENT = STRESS.numTiles > 0
+            ? 0.5f * glm::sqrt( (GLfloat)STRESS.numTiles / glm::clamp(STRESS.density, 0.001f, 1.0f) )
+            : WORLD_SIZE;
+    std::mt19937 rng( _settings.worldSeed ^ 0x5EED5EEDu );
+    std::uniform_real_distribution<GLfloat> area( -HALF_EXTENT, HALF_EXTENT );
+    std::uniform_real_distribution<GLfloat> unit( 0.0f, 1.0f );
+
+    _stressHeroes.reserve( STRESS.numHeroes );
+    for(GLuint i = 0; i < STRESS.numHeroes; i++) {
+        _stressHeroes.push_back( {glm::vec3(area(rng), 0.0f, area(rng)), unit(rng) * 2.0f * glm::pi<GLfloat>()} );
+    }
+
+    GLuint numLights = STRESS.numLights;
+    if( numLights > MAX_POINT_LIGHTS ) {
+        fprintf( stderr, "[WARN]: The shader supports %u point lights, %u requested\n", MAX_POINT_LIGHTS, numLights );
+        numLights = MAX_POINT_LIGHTS;
+    }
+    for(GLuint i = 0; i < numLights; i++) {
+        _pointLightPositions.emplace_back( area(rng), glm::mix(1.0f, 4.0f, unit(rng)), area(rng) );
+        _pointLightColors.emplace_back( unit(rng), unit(rng), unit(rng) );
+    }
+
+    fprintf( stdout, "[INFO]: Stress scene has %zu extra heroes and %zu point lights\n", _stressHeroes.size(), _pointLightPositions.size() );
+}
+
 void A3Engine::mSetupScene() {
+    const int64_t phaseStart = Profiler::now();
+    A3_PROFILE_FUNCTION();
+
     _pArcballCam = new CSCI441::ArcballCam();
     _pArcballCam->setRadius(25.0f);
     _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) );
@@ -230,13 +656,110 @@ void A3Engine::mSetupScene() {
     _pArcballCam->setTheta(-M_PI / 7.0f );
     _pArcballCam->setPhi(M_PI / 1.2f );
     _pArcballCam->recomputeOrientation();
+    _pArcballCam->setReversedDepth(_isReverseZEnabled);
     _cameraSpeed = glm::vec2(0.25f, 0.02f);
 
+    // Get the size of our framebuffer.  Ideally this should be the same dimensions as our window, but
+    // when using a Retina display the actual window can be larger than the requested window.  Therefore,
+    // query what the actual size of the window we are rendering to is.  After this it is only updated
+    // when the framebuffer is resized.
+    GLint framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize( mpWindow, &framebufferWidth, &framebufferHeight );
+    handleFramebufferSizeEvent( framebufferWidth, framebufferHeight );
+
+    _sendLightingUniforms();
+
+    _endStartupPhase( "setupScene", phaseStart );
+}
+
+void A3Engine::_sendLightingUniforms() const {
     // TODO #6: set lighting uniforms
     glm::vec3 lightDirection(-1.0f, -1.0f, -1.0f);
     glm::vec3 lightColor(1.0f,1.0f,1.0f);
     glProgramUniform3fv(_lightingShaderProgram->getShaderProgramHandle(), _lightingShaderUniformLocations.lightDirection, 1, &lightDirection[0]);
     glProgramUniform3fv(_lightingShaderProgram->getShaderProgramHandle(), _lightingShaderUniformLocations.lightColor, 1, &lightColor[0]);
+
+    // point lights of a stress scene never move, so they are only sent once
+    glProgramUniform1i(_lightingShaderProgram->getShaderProgramHandle(), _lightingShaderUniformLocations.numPointLights, (GLint)_pointLightPositions.size());
+    if( !_pointLightPositions.empty() ) {
+        glProgramUniform3fv(_lightingShaderProgram->getShaderProgramHandle(), _lightingShaderUniformLocations.pointLightPositions,
+                            (GLsizei)_pointLightPositions.size(), &_pointLightPositions[0][0]);
+        glProgramUniform3fv(_lightingShaderProgram->getShaderProgramHandle(), _lightingShaderUniformLocations.pointLightColors,
+                            (GLsizei)_pointLightColors.size(), &_pointLightColors[0][0]);
+    }
+}
+
+void A3Engine::_swapLightingShaderProgram(CSCI441::ShaderProgram* pShaderProgram) {
+    // the cache deletes the old program, OpenGL keeps it alive until the frames in flight are done with it
+    _pLightingShaders->replaceProgram( _lightingFeatures, pShaderProgram );
+    _lightingShaderProgram = pShaderProgram;
+
+    // the attributes have fixed locations in the shader, so the vertex arrays still match
+    _lookupLightingShaderUniforms();
+    _sendLightingUniforms();
+    _pHero->setShaderProgram(_lightingShaderProgram->getShaderProgramHandle(),
+                             _lightingShaderUniformLocations.mvpMatrix,
+                             _lightingShaderUniformLocations.modelMatrix,
+                             _lightingShaderUniformLocations.normalMatrix,
+                             _lightingShaderUniformLocations.materialColor);
+
+    fprintf( stdout, "[INFO]: Swapped in the reloaded lighting shader program\n" );
+}
+
+void A3Engine::_startBackgroundSetup() {
+    _environmentPhase = {"generateEnvironment", 0, 0, true};
+    _shaderPrefetchPhase = {"prefetchShaderSources", 0, 0, true};
+
+    _pJobSystem->submit("generateEnvironment", [this] {
+        _environmentPhase.start = Profiler::now();
+        _generateEnvironment();
+        _generateStressActors();
+        _environmentPhase.end = Profiler::now();
+    }, &_backgroundSetupJobs);
+
+    // maps and preprocesses the sources into the shader source cache so the compiles on the
+    // main thread find them ready
+    _pJobSystem->submit("prefetchShaderSources", [this] {
+        _shaderPrefetchPhase.start = Profiler::now();
+        const std::vector<std::string> lightingDefines = _pLightingShaders->getDefines(_lightingFeatures);
+        for(const char* filename : LIGHTING_SHADER_FILES) {
+            CSCI441::ShaderSourceCache::load(filename, lightingDefines);
+        }
+        for(const char* filename : OVERLAY_SHADER_FILES) {
+            CSCI441::ShaderSourceCache::load(filename);
+        }
+        _shaderPrefetchPhase.end = Profiler::now();
+    }, &_backgroundSetupJobs);
+}
+
+void A3Engine::_finishBackgroundSetup() {
+    const int64_t waitStart = Profiler::now();
+    {
+        A3_PROFILE_SCOPE("waitForBackgroundSetup");
+        _pJobSystem->wait(_backgroundSetupJobs);
+    }
+    _endStartupPhase( "waitForBackgroundSetup", waitStart );
+
+    _startupPhases.push_back(_shaderPrefetchPhase);
+    _startupPhases.push_back(_environmentPhase);
+}
+
+void A3Engine::_endStartupPhase(const char* name, const int64_t start) {
+    _startupPhases.push_back({name, start, Profiler::now(), false});
+}
+
+void A3Engine::_reportStartup() {
+    _isStartupReported = true;
+
+    fprintf( stdout, "[INFO]: Startup breakdown, from launch:\n" );
+    for(const StartupPhase& phase : _startupPhases) {
+        fprintf( stdout, "[INFO]:   %-24s at %8.2f ms took %8.2f ms%s\n", phase.name,
+                 (GLdouble)phase.start / 1000000.0, (GLdouble)(phase.end - phase.start) / 1000000.0,
+                 phase.isBackground ? " on a worker" : "" );
+    }
+    const int64_t firstFrameTime = _firstFrameTime.load(std::memory_order_acquire);
+    fprintf( stdout, "[INFO]: First frame finished %.2f ms after launch, %.2f ms after setup\n",
+             (GLdouble)firstFrameTime / 1000000.0, (GLdouble)(firstFrameTime - _runStartTime) / 1000000.0 );
 }
 
 //*************************************************************************************
@@ -245,7 +768,13 @@ void A3Engine::mSetupScene() {
 
 void A3Engine::mCleanupShaders() {
     fprintf( stdout, "[INFO]: ...deleting Shaders.\n" );
-    delete _lightingShaderProgram;
+    // stop compiling before the programs it would replace are gone
+    delete _pShaderHotReloader;
+    _pShaderHotReloader = nullptr;
+    _pLightingShaders->clear();
+    // the compiled stages kept for reuse go with the programs
+    CSCI441::ShaderObjectPool::flush();
+    _lightingShaderProgram = nullptr;
 }
 
 void A3Engine::mCleanupBuffers() {
@@ -258,116 +787,158 @@ void A3Engine::mCleanupBuffers() {
 
     fprintf( stdout, "[INFO]: ...deleting models..\n" );
     delete _pHero;
+
+    fprintf( stdout, "[INFO]: ...deleting frame resources..\n" );
+    delete _pFrameResources;
+    delete _pGpuProfiler;
+    delete _pTextOverlay;
+    delete _pSceneTarget;
 }
 
 //*************************************************************************************
 //
 // Rendering / Drawing Functions - this is where the magic happens!
 
-void A3Engine::_renderScene(glm::mat4 viewMtx, glm::mat4 projMtx) const {
+void A3Engine::_renderScene(const SceneSnapshot& snapshot) {
+    A3_PROFILE_FUNCTION();
+
+    //// BEGIN BUILDING THE TILE COMMANDS ////
+    // build the view independent per-tile uniforms across the workers, only the GL calls stay on this thread
+    _tileDrawCommands.resize(snapshot.visibleTiles.size());
+    _pJobSystem->parallelForAndWait("buildTileCommands", snapshot.visibleTiles.size(), 256, [&](size_t begin, size_t end) {
+        for(size_t i = begin; i < end; i++) {
+            const TileData& currentTile = _tiles[ snapshot.visibleTiles[i] ];
+            TileDrawCommand& command = _tileDrawCommands[i];
+            command.modelMtx = currentTile.modelMatrix;
+            command.normalMtx = glm::mat3(glm::transpose(glm::inverse(currentTile.modelMatrix)));
+            command.color = currentTile.color;
+        }
+    });
+    //// END BUILDING THE TILE COMMANDS ////
+
+    // pick up the newest camera now that the CPU work is done and the draws are about to go out
+    const glm::mat4 viewMtx = _latchViewMatrix(snapshot);
+    const glm::mat4& projMtx = snapshot.projMtx;
+
     // use our lighting shader program
     _lightingShaderProgram->useProgram();
 
     //// BEGIN DRAWING THE GROUND PLANE ////
-    // draw the ground plane
-    glm::mat4 groundModelMtx = glm::scale( glm::mat4(1.0f), glm::vec3(WORLD_SIZE, 1.0f, WORLD_SIZE));
-    _computeAndSendMatrixUniforms(groundModelMtx, viewMtx, projMtx);
+    {
+        A3_GPU_PROFILE_SCOPE(_pGpuProfiler, "ground");
 
-    glm::vec3 groundColor(0.9f, 0.9f, 0.9f);
-    _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialColor, groundColor);
+        // draw the ground plane
+        glm::mat4 groundModelMtx = glm::scale( glm::mat4(1.0f), glm::vec3(WORLD_SIZE, 1.0f, WORLD_SIZE));
+        _computeAndSendMatrixUniforms(groundModelMtx, viewMtx, projMtx);
 
-    glBindVertexArray(_groundVAO);
-    glDrawElements(GL_TRIANGLE_STRIP, _numGroundPoints, GL_UNSIGNED_SHORT, (void*)0);
+        glm::vec3 groundColor(0.9f, 0.9f, 0.9f);
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialColor, groundColor);
+
+        countedBindVertexArray(_groundVAO);
+        countedDrawElements(GL_TRIANGLE_STRIP, _numGroundPoints, GL_UNSIGNED_SHORT, (void*)0);
+    }
     //// END DRAWING THE GROUND PLANE ////
 
     //// BEGIN DRAWING THE TILES ////
-    for( const TileData& currentTile : _tiles ) {
-        _computeAndSendMatrixUniforms(currentTile.modelMatrix, viewMtx, projMtx);
-
-        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialColor, currentTile.color);
+    {
+        A3_GPU_PROFILE_SCOPE(_pGpuProfiler, "tiles");
+
+        const glm::mat4 viewProjMtx = projMtx * viewMtx;
+        const bool hasPointLights = !_pointLightPositions.empty();
+        for( const TileDrawCommand& command : _tileDrawCommands ) {
+            _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.mvpMatrix, viewProjMtx * command.modelMtx);
+            // the model matrix is only read by the point lights
+            if( hasPointLights ) {
+                _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.modelMatrix, command.modelMtx);
+            }
+            _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.normalMatrix, command.normalMtx);
+            _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.materialColor, command.color);
 
-        CSCI441::drawSolidCube(1.0);
+            countedDrawSolidCube(1.0);
+        }
     }
     //// END DRAWING THE TILES ////
 
     //// BEGIN DRAWING THE HERO ////
-    glm::mat4 modelMtx(1.0f);
-    // we are going to cheat and use our look at point to place our hero so that it is always in view
-    modelMtx = glm::translate(modelMtx, _pArcballCam->getLookAtPoint() );
-    // draw our hero now
-    _pHero->drawHero(modelMtx, viewMtx, projMtx );
+    {
+        A3_GPU_PROFILE_SCOPE(_pGpuProfiler, "hero");
+
+        glm::mat4 modelMtx(1.0f);
+        // draw the hero at its interpolated simulated position, scaled like the follow camera's target
+        modelMtx = glm::translate(modelMtx, snapshot.heroPosition );
+        // draw our hero now
+        _pHero->drawHero(modelMtx, snapshot.heroBodyAngle, viewMtx, projMtx );
+    }
+
+    // the extra heroes of a stress scene stand still where they were placed
+    if( !_stressHeroes.empty() ) {
+        A3_GPU_PROFILE_SCOPE(_pGpuProfiler, "stressHeroes");
+
+        for( const StressHero& stressHero : _stressHeroes ) {
+            _pHero->drawHero(glm::translate(glm::mat4(1.0f), stressHero.position), stressHero.bodyAngle, viewMtx, projMtx );
+        }
+    }
     //// END DRAWING THE HERO ////
 }
 
+glm::mat4 A3Engine::_latchViewMatrix(const SceneSnapshot& snapshot) {
+    if( !_settings.lateLatchCamera ) return snapshot.viewMtx;
+
+    // the main thread publishes the next snapshot as soon as this one is taken, so the newest
+    // view usually belongs to a later snapshot already.  take it anyway, the camera is what
+    // has to answer the input quickly, only a view older than the snapshot is passed over
+    GLfloat theta, phi, radius;
+    {
+        std::lock_guard<std::mutex> lock(_lateViewMutex);
+        _numLatchedFrames++;
+        if( _lateView.snapshotNumber < snapshot.snapshotNumber ) return snapshot.viewMtx;
+        theta = _lateView.theta;
+        phi = _lateView.phi;
+        radius = _lateView.radius;
+    }
+
+    // only the turn and zoom are taken, no further than the tiles were culled for, the camera
+    // still looks at this snapshot's point so the hero stays where the snapshot put it
+    theta = glm::clamp(theta, snapshot.cameraTheta - LATE_LATCH_MAX_TURN, snapshot.cameraTheta + LATE_LATCH_MAX_TURN);
+    phi = glm::clamp(phi, snapshot.cameraPhi - LATE_LATCH_MAX_TURN, snapshot.cameraPhi + LATE_LATCH_MAX_TURN);
+    radius = glm::clamp(radius, snapshot.cameraRadius - LATE_LATCH_MAX_ZOOM, snapshot.cameraRadius + LATE_LATCH_MAX_ZOOM);
+    if( theta == snapshot.cameraTheta && phi == snapshot.cameraPhi && radius == snapshot.cameraRadius ) {
+        return snapshot.viewMtx;
+    }
+
+    // an empty zone marks the frames the latch changed in the trace
+    { A3_PROFILE_SCOPE("lateLatchHit"); }
+    _numLateViewsUsed++;
+    return CSCI441::ArcballCam::computeOrbitViewMatrix(theta, phi, radius, snapshot.cameraLookAtPoint, snapshot.cameraUpVector);
+}
+
+void A3Engine::_publishLateViewMatrix() {
+    std::lock_guard<std::mutex> lock(_lateViewMutex);
+    _lateView.theta = _pArcballCam->getTheta();
+    _lateView.phi = _pArcballCam->getPhi();
+    _lateView.radius = _pArcballCam->getRadius();
+    _lateView.snapshotNumber = _snapshotNumber;
+}
+
 void A3Engine::_updateScene() {
-    // Handle the hero's forward movement and checks for environment boundaries.
+    A3_PROFILE_FUNCTION();
+
+    // Handle the hero's forward movement.
     if(_keys[GLFW_KEY_W]) {
         heroPosition.x += cos(_pHero->getBodyAngle());
         heroPosition.z += -sin(_pHero->getBodyAngle());
-        _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-        _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-        _pArcballCam->recomputeOrientation();
-
-        if(heroPosition.x > 550.0f) {
-            heroPosition.x = 550.0f;
-            _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-            _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-            _pArcballCam->recomputeOrientation();
-        }
-        if(heroPosition.x < -550.0f) {
-            heroPosition.x = -550.0f;
-            _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-            _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-            _pArcballCam->recomputeOrientation();
-        }
-        if(heroPosition.z > 550.0f) {
-            heroPosition.z = 550.0f;
-            _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-            _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-            _pArcballCam->recomputeOrientation();
-        }
-        if(heroPosition.z < -550.0f) {
-            heroPosition.z = -550.0f;
-            _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-            _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-            _pArcballCam->recomputeOrientation();
-        }
     }
 
-    // Handle the hero's backward movement and checks for environment boundaries.
+    // Handle the hero's backward movement.
     if(_keys[GLFW_KEY_S]) {
         heroPosition.x -= cos(_pHero->getBodyAngle());
         heroPosition.z -= -sin(_pHero->getBodyAngle());
-        _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-        _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-        _pArcballCam->recomputeOrientation();
-
-        if(heroPosition.x > 550.0f) {
-            heroPosition.x = 550.0f;
-            _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-            _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-            _pArcballCam->recomputeOrientation();
-        }
-        if(heroPosition.x < -550.0f) {
-            heroPosition.x = -550.0f;
-            _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-            _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-            _pArcballCam->recomputeOrientation();
-        }
-        if(heroPosition.z > 550.0f) {
-            heroPosition.z = 550.0f;
-            _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-            _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-            _pArcballCam->recomputeOrientation();
-        }
-        if(heroPosition.z < -550.0f) {
-            heroPosition.z = -550.0f;
-            _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-            _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
-            _pArcballCam->recomputeOrientation();
-        }
     }
 
+    // Checks for environment boundaries.
+    heroPosition.x = glm::clamp(heroPosition.x, -550.0f, 550.0f);
+    heroPosition.z = glm::clamp(heroPosition.z, -550.0f, 550.0f);
+
     // Rotates the hero's heading left or right.
     if(_keys[GLFW_KEY_D]) {
         _pHero->turnRight();
@@ -381,35 +952,444 @@ void A3Engine::_updateScene() {
     _hoverAmount = _yOffset * std::sin(M_PI/180 * _timeVariable);
     heroPosition.y += _hoverAmount;
     _timeVariable += 1;
-    _pArcballCam->setPosition(glm::vec3(heroPosition.x, heroPosition.y, heroPosition.z) * 0.1f );
-    _pArcballCam->setLookAtPoint(_pArcballCam->getPosition());
+}
+
+GLuint A3Engine::_advanceSimulation(const GLdouble elapsedSeconds) {
+    A3_PROFILE_FUNCTION();
+
+    const GLdouble TIMESTEP = 1.0 / _settings.simulationRate;
+    // faster than real time runs need proportionally more steps per frame to keep up
+    const GLuint MAX_STEPS = _settings.maxCatchUpSteps * (GLuint)glm::max(1.0, glm::ceil(_settings.timeScale));
+
+    _simulationAccumulator += elapsedSeconds * _settings.timeScale;
+
+    GLuint numSteps = 0;
+    while(_simulationAccumulator >= TIMESTEP && numSteps < MAX_STEPS) {
+        _previousState = _currentState;
+
+        if( _inputReplayer.isLoaded() ) {
+            _replayInput();
+        }
+        if( _benchmarkScript.isLoaded() ) {
+            _applyScriptedHero( (GLdouble)_simulationTick / _settings.simulationRate );
+        }
+        _updateScene();
+        _simulationTick++;
+
+        _currentState.heroPosition = heroPosition;
+        _currentState.heroBodyAngle = _pHero->getBodyAngle();
+
+        _simulationAccumulator -= TIMESTEP;
+        numSteps++;
+    }
+
+    // too far behind to catch up, drop the backlog instead of spiraling
+    if(_simulationAccumulator >= TIMESTEP) {
+        _simulationAccumulator = std::fmod(_simulationAccumulator, TIMESTEP);
+    }
+
+    return numSteps;
+}
+
+void A3Engine::_interpolateScene(const GLfloat alpha) {
+    // blend between the last two simulation steps so motion is smooth at any frame rate
+    _renderState.heroPosition = glm::mix(_previousState.heroPosition, _currentState.heroPosition, alpha);
+    _renderState.heroBodyAngle = glm::mix(_previousState.heroBodyAngle, _currentState.heroBodyAngle, alpha);
+
+    // the camera follows the hero, its view is only rebuilt once the snapshot asks for it
+    _pArcballCam->setLookAtPoint(_renderState.heroPosition * 0.1f );
+    if( _benchmarkScript.isLoaded() ) {
+        _applyScriptedCamera( ((GLdouble)_simulationTick - 1.0 + alpha) / _settings.simulationRate );
+    }
     _pArcballCam->recomputeOrientation();
 }
 
+void A3Engine::_replayInput() {
+    // events go through the same handlers live input does, before the step they were recorded at
+    while( const InputEvent* pEvent = _inputReplayer.nextEvent(_simulationTick) ) {
+        switch( pEvent->type ) {
+            case InputEvent::Type::KEY:
+                handleKeyEvent(pEvent->code, pEvent->action);
+                break;
+            case InputEvent::Type::MOUSE_BUTTON:
+                handleMouseButtonEvent(pEvent->code, pEvent->action);
+                break;
+            case InputEvent::Type::CURSOR_POSITION:
+                handleCursorPositionEvent(pEvent->position);
+                break;
+        }
+    }
+    _applyCameraInput();
+
+    if( _inputReplayer.isFinished(_simulationTick) && !glfwWindowShouldClose(mpWindow) ) {
+        fprintf( stdout, "[INFO]: Replay finished at tick %llu\n", (unsigned long long)_simulationTick );
+        setWindowShouldClose();
+    }
+}
+
+void A3Engine::_applyScriptedHero(const GLdouble time) {
+    const BenchmarkScript::HeroKey held = _benchmarkScript.sampleHero(time);
+    _keys[GLFW_KEY_W] = held.forward;
+    _keys[GLFW_KEY_S] = held.backward;
+    _keys[GLFW_KEY_A] = held.left;
+    _keys[GLFW_KEY_D] = held.right;
+}
+
+void A3Engine::_applyScriptedCamera(const GLdouble time) {
+    BenchmarkScript::CameraKey key;
+    if( !_benchmarkScript.sampleCamera(time, key) ) return;
+
+    _pArcballCam->setTheta(key.theta);
+    _pArcballCam->setPhi(key.phi);
+    _pArcballCam->setRadius(key.radius);
+    if( key.hasLookAtPoint ) {
+        _pArcballCam->setLookAtPoint(key.lookAtPoint);
+    }
+}
+
+bool A3Engine::_isSceneIdle() const {
+    if( _isSceneDirty ) return false;
+
+    // a recompiled shader is only swapped in when a frame is drawn
+    if( _pShaderHotReloader != nullptr && _pShaderHotReloader->hasPendingReloads() ) return false;
+
+    // a held movement key keeps the hero going
+    if( _keys[GLFW_KEY_W] || _keys[GLFW_KEY_S] || _keys[GLFW_KEY_A] || _keys[GLFW_KEY_D] ) return false;
+
+    // the last step of a move still has to be drawn in full, after that only the hover changes
+    return _previousState.heroPosition.x == _currentState.heroPosition.x
+        && _previousState.heroPosition.z == _currentState.heroPosition.z
+        && _previousState.heroBodyAngle == _currentState.heroBodyAngle;
+}
+
+void A3Engine::_publishSceneSnapshot() {
+    A3_PROFILE_FUNCTION();
+
+    SceneSnapshot& snapshot = _sceneSnapshots.beginWrite();
+
+    snapshot.snapshotNumber = ++_snapshotNumber;
+    Profiler::setFrameNumber(_snapshotNumber);
+    snapshot.viewMtx = _pArcballCam->getViewMatrix();
+    snapshot.projMtx = _pArcballCam->getProjectionMatrix();
+    snapshot.cameraTheta = _pArcballCam->getTheta();
+    snapshot.cameraPhi = _pArcballCam->getPhi();
+    snapshot.cameraRadius = _pArcballCam->getRadius();
+    snapshot.cameraLookAtPoint = _pArcballCam->getLookAtPoint();
+    snapshot.cameraUpVector = _pArcballCam->getUpVector();
+    // the point the camera follows, taken from the simulation since a script may point the camera elsewhere
+    snapshot.heroPosition = _renderState.heroPosition * 0.1f;
+    snapshot.heroBodyAngle = _renderState.heroBodyAngle;
+
+    snapshot.framebufferWidth = _framebufferSize.x;
+    snapshot.framebufferHeight = _framebufferSize.y;
+
+    _cullTiles(snapshot.projMtx * snapshot.viewMtx, snapshot.cameraLookAtPoint, snapshot.visibleTiles);
+
+    if( _settings.lateLatchCamera ) _publishLateViewMatrix();
+
+    _sceneSnapshots.publish();
+}
+
+void A3Engine::_cullTiles(const glm::mat4& viewProjMtx, const glm::vec3& lookAtPoint, std::vector<GLuint>& visibleTiles) {
+    A3_PROFILE_FUNCTION();
+
+    // the late latch turns the camera about the look at point by at most a turn on each axis,
+    // which moves a point at most its distance from the look at point times the angle, and
+    // zooming out moves each side plane out by at most the zoom
+    const GLfloat turnMargin = _settings.lateLatchCamera ? 2.0f * LATE_LATCH_MAX_TURN : 0.0f;
+    const GLfloat zoomMargin = _settings.lateLatchCamera ? LATE_LATCH_MAX_ZOOM : 0.0f;
+
+    // extract the left, right, bottom and top clip planes from the combined matrix.  near and
+    // far are skipped so the test holds for any depth mapping the projection uses
+    const glm::vec4 row0(viewProjMtx[0][0], viewProjMtx[1][0], viewProjMtx[2][0], viewProjMtx[3][0]);
+    const glm::vec4 row1(viewProjMtx[0][1], viewProjMtx[1][1], viewProjMtx[2][1], viewProjMtx[3][1]);
+    const glm::vec4 row3(viewProjMtx[0][3], viewProjMtx[1][3], viewProjMtx[2][3], viewProjMtx[3][3]);
+    glm::vec4 planes[4] = { row3 + row0, row3 - row0, row3 + row1, row3 - row1 };
+    for(glm::vec4& plane : planes) {
+        plane /= glm::length( glm::vec3(plane) );
+    }
+
+    // each chunk of tiles is tested by its own job into its own list
+    const size_t CULL_GRAIN_SIZE = 512;
+    const size_t numChunks = (_tiles.size() + CULL_GRAIN_SIZE - 1) / CULL_GRAIN_SIZE;
+    if(_cullingChunkResults.size() < numChunks) _cullingChunkResults.resize(numChunks);
+
+    _pJobSystem->parallelForAndWait("cullTiles", _tiles.size(), CULL_GRAIN_SIZE, [&](size_t begin, size_t end) {
+        std::vector<GLuint>& chunkResults = _cullingChunkResults[begin / CULL_GRAIN_SIZE];
+        chunkResults.clear();
+        for(size_t i = begin; i < end; i++) {
+            const TileData& tile = _tiles[i];
+            const GLfloat margin = tile.boundingRadius + zoomMargin
+                                 + turnMargin * glm::distance(tile.boundingCenter, lookAtPoint);
+            bool isVisible = true;
+            for(const glm::vec4& plane : planes) {
+                if( glm::dot(glm::vec3(plane), tile.boundingCenter) + plane.w < -margin ) {
+                    isVisible = false;
+                    break;
+                }
+            }
+            if(isVisible) chunkResults.push_back((GLuint)i);
+        }
+    });
+
+    // merge the chunks in order so tiles keep drawing in grid order
+    visibleTiles.clear();
+    for(size_t chunk = 0; chunk < numChunks; chunk++) {
+        visibleTiles.insert(visibleTiles.end(), _cullingChunkResults[chunk].begin(), _cullingChunkResults[chunk].end());
+    }
+}
+
+void A3Engine::_resizeRenderTargets(GLint width, GLint height) {
+    // update the viewport - tell OpenGL we want to render to the whole window
+    glViewport( 0, 0, width, height );
+
+    if( _pSceneTarget != nullptr ) {
+        _pSceneTarget->resize( width, height );
+    }
+}
+
+void A3Engine::_renderLoop() {
+    Profiler::setThreadName("render");
+
+    // the render thread owns the context for as long as it runs
+    glfwMakeContextCurrent(mpWindow);
+
+    GLint viewportWidth = 0, viewportHeight = 0;
+    GLdouble lastCpuFrameTime = 0.0;
+
+    // draw each snapshot the main thread hands us until the buffer is closed
+    while( const SceneSnapshot* pSnapshot = _sceneSnapshots.acquire() ) {
+        // the render thread runs a frame behind the main thread, so tag its zones with the frame it draws
+        Profiler::setThreadFrameNumber(pSnapshot->snapshotNumber);
+        A3_PROFILE_SCOPE("renderFrame");
+        const auto frameStartTime = std::chrono::steady_clock::now();
+        const GLuint64 frameNumber = _pFrameResources->getFrameNumber();
+
+        // programs recompiled since the last frame are swapped in before anything is drawn with them
+        if( _pShaderHotReloader != nullptr ) _pShaderHotReloader->applyReloads();
+
+        // wait until the GPU has retired the frame that last used this frame's resources
+        {
+            A3_PROFILE_SCOPE("waitForFrameFence");
+            _pFrameResources->beginFrame();
+        }
+        // the slot's fence has passed, so its GPU scopes are normally ready without waiting
+        if( _pGpuProfiler != nullptr ) _pGpuProfiler->beginFrame();
+        RenderStats::beginFrame();
+
+        // only touch size dependent state when the framebuffer actually changed size
+        if( pSnapshot->framebufferWidth != viewportWidth || pSnapshot->framebufferHeight != viewportHeight ) {
+            viewportWidth = pSnapshot->framebufferWidth;
+            viewportHeight = pSnapshot->framebufferHeight;
+            _resizeRenderTargets( viewportWidth, viewportHeight );
+        }
+
+        if( _pSceneTarget != nullptr ) {
+            _pSceneTarget->bind();                      // draw offscreen, copied to the window at the end
+        } else {
+            glDrawBuffer( GL_BACK );				    // work with our back frame buffer
+        }
+        {
+            A3_GPU_PROFILE_SCOPE(_pGpuProfiler, "frame");
+
+            glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );	// clear the current color contents and depth buffer in the window
+
+            // draw everything to the window
+            _renderScene(*pSnapshot);
+
+            if( _pTextOverlay != nullptr && _isStatsOverlayVisible ) {
+                _drawStatsOverlay( viewportWidth, viewportHeight, lastCpuFrameTime );
+            }
+        }
+        if( _pGpuProfiler != nullptr ) _pGpuProfiler->endFrame();
+        RenderStats::endFrame();
+
+        if( _settings.headless ) {
+            // nothing is ever shown, keep the frame offscreen and only flush it to the GPU
+            _pFrameResources->endFrame();
+            glFlush();
+
+            const auto cpuFrameTime = std::chrono::steady_clock::now() - frameStartTime;
+            if( frameNumber < _frameTimings.size() ) {
+                _frameTimings[frameNumber].cpuTime = std::chrono::duration<GLdouble, std::milli>(cpuFrameTime).count();
+                _frameTimings[frameNumber].stats = RenderStats::getLastFrame();
+            }
+            if( _isTelemetryEnabled ) {
+                _frameTelemetry.record( FrameTelemetry::Metric::CPU, std::chrono::duration_cast<std::chrono::nanoseconds>(cpuFrameTime).count() );
+                _frameTelemetry.publish();
+            }
+            if( _firstFrameTime.load(std::memory_order_relaxed) == 0 ) _firstFrameTime.store(Profiler::now(), std::memory_order_release);
+            continue;
+        }
+
+        if( _pSceneTarget != nullptr ) {
+            _pSceneTarget->blitToDefaultFramebuffer();
+        }
+
+        // fence this frame so its resources are not reused while the GPU still needs them
+        _pFrameResources->endFrame();
+        const auto cpuFrameTime = std::chrono::steady_clock::now() - frameStartTime;
+        lastCpuFrameTime = std::chrono::duration<GLdouble, std::milli>(cpuFrameTime).count();
+
+        {
+            A3_PROFILE_SCOPE("swapBuffers");
+            const auto presentStartTime = std::chrono::steady_clock::now();
+            glfwSwapBuffers(mpWindow);                   // flush the OpenGL commands and make sure they get rendered!
+            const auto presentTime = std::chrono::steady_clock::now() - presentStartTime;
+            if( _firstFrameTime.load(std::memory_order_relaxed) == 0 ) _firstFrameTime.store(Profiler::now(), std::memory_order_release);
+
+            if( _isTelemetryEnabled ) {
+                _frameTelemetry.record( FrameTelemetry::Metric::CPU, std::chrono::duration_cast<std::chrono::nanoseconds>(cpuFrameTime).count() );
+                _frameTelemetry.record( FrameTelemetry::Metric::PRESENT, std::chrono::duration_cast<std::chrono::nanoseconds>(presentTime).count() );
+                _frameTelemetry.publish();
+            }
+        }
+    }
+
+    // collect the timer queries of the frames that are still in flight
+    _pFrameResources->retireAll();
+    if( _pGpuProfiler != nullptr ) _pGpuProfiler->retireAll();
+    if( _isTelemetryEnabled ) _frameTelemetry.publish(true);
+
+    // hand the context back so the main thread can clean up
+    glFinish();
+    glfwMakeContextCurrent(nullptr);
+}
+
+void A3Engine::_drawStatsOverlay(const GLint width, const GLint height, const GLdouble cpuFrameTime) {
+    const RenderStats::Counters& stats = RenderStats::getLastFrame();
+    char line[64];
+
+    snprintf( line, sizeof(line), "FRAME %llu", (unsigned long long)_pFrameResources->getFrameNumber() );
+    _pTextOverlay->addText( 0, 0, line );
+    snprintf( line, sizeof(line), "CPU %.2f MS  GPU %.2f MS", cpuFrameTime, (GLdouble)_pFrameResources->getLastGpuFrameTime() / 1000000.0 );
+    _pTextOverlay->addText( 0, 1, line );
+    snprintf( line, sizeof(line), "DRAWS %llu  INSTANCES %llu", (unsigned long long)stats.drawCalls, (unsigned long long)stats.instances );
+    _pTextOverlay->addText( 0, 2, line );
+    snprintf( line, sizeof(line), "TRIANGLES %llu", (unsigned long long)stats.triangles );
+    _pTextOverlay->addText( 0, 3, line );
+    snprintf( line, sizeof(line), "UNIFORMS %llu  %.1f KB", (unsigned long long)stats.uniformUploads, (GLdouble)stats.uniformBytes / 1024.0 );
+    _pTextOverlay->addText( 0, 4, line );
+    snprintf( line, sizeof(line), "PROGRAM BINDS %llu  VAO BINDS %llu", (unsigned long long)stats.programBinds, (unsigned long long)stats.vertexArrayBinds );
+    _pTextOverlay->addText( 0, 5, line );
+    snprintf( line, sizeof(line), "UPLOADED %.1f KB", (GLdouble)stats.bytesUploaded / 1024.0 );
+    _pTextOverlay->addText( 0, 6, line );
+
+    _pTextOverlay->draw( *_pFrameResources, width, height );
+}
+
 void A3Engine::run() {
-    //  This is our draw loop - all rendering is done here.  We use a loop to keep the window open
-    //	until the user decides to close the window and quit the program.  Without a loop, the
-    //	window will display once and then the program exits.
+    _runStartTime = Profiler::now();
+
+    // the render thread takes over the context, the main thread keeps the window and its events
+    glfwMakeContextCurrent(nullptr);
+    std::thread renderThread(&A3Engine::_renderLoop, this);
+
+    //  This is our update loop - the main thread handles events and simulation while the render
+    //	thread draws the previous snapshot.  We use a loop to keep the window open until the user
+    //	decides to close the window and quit the program.
+    auto previousTime = std::chrono::steady_clock::now();
+    // while idle the hover is only drawn at the idle animation rate
+    const auto IDLE_FRAME_PERIOD = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<GLdouble>( _settings.idleAnimationRate > 0.0 ? 1.0 / _settings.idleAnimationRate : 0.0 ) );
+    auto nextIdleFrameTime = previousTime;
     while( !glfwWindowShouldClose(mpWindow) ) {	        // check if the window was instructed to be closed
-        glDrawBuffer( GL_BACK );				        // work with our back frame buffer
-        glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );	// clear the current color contents and depth buffer in the window
+        A3_PROFILE_SCOPE("mainLoop");
+
+        // wait for the render thread to take the last snapshot before sampling any input, so the
+        // next snapshot is built from the newest input instead of aging in the buffer for a frame
+        const std::chrono::milliseconds WAIT_SLICE( _settings.lateLatchCamera ? 1 : 100 );
+        {
+            A3_PROFILE_SCOPE("waitForRenderThread");
+            while( !_sceneSnapshots.waitUntilConsumed(WAIT_SLICE) && !glfwWindowShouldClose(mpWindow) ) {
+                if( _settings.lateLatchCamera ) {
+                    // keep the camera of the snapshot being drawn up to date until its draws go out
+                    glfwPollEvents();
+                    _applyCameraInput();
+                    _publishLateViewMatrix();
+                }
+            }
+        }
 
-        // Get the size of our framebuffer.  Ideally this should be the same dimensions as our window, but
-        // when using a Retina display the actual window can be larger than the requested window.  Therefore,
-        // query what the actual size of the window we are rendering to is.
-        GLint framebufferWidth, framebufferHeight;
-        glfwGetFramebufferSize( mpWindow, &framebufferWidth, &framebufferHeight );
+        // a headless run stops once its last frame has been picked up
+        if( _settings.headless && _snapshotNumber >= _settings.benchmarkFrames ) break;
+
+        const bool wasIdle = _settings.idleMode && !_settings.headless && _isSceneIdle();
+        {
+            A3_PROFILE_SCOPE("handleEvents");
+            if( wasIdle ) {
+                // nothing to show but the hover, sleep until an event arrives or the hover's next frame is due
+                if( _settings.idleAnimationRate > 0.0 ) {
+                    const GLdouble timeUntilIdleFrame = std::chrono::duration<GLdouble>(nextIdleFrameTime - std::chrono::steady_clock::now()).count();
+                    glfwWaitEventsTimeout( glm::max(timeUntilIdleFrame, 0.0) );
+                } else {
+                    glfwWaitEvents();
+                }
+            } else {
+                glfwPollEvents();				        // check for any events
+            }
+            _applyCameraInput();                        // apply this frame's mouse movement in one go
+        }
 
-        // update the viewport - tell OpenGL we want to render to the whole window
-        glViewport( 0, 0, framebufferWidth, framebufferHeight );
+        // the render thread only records, the formatting and file writes happen out here
+        if( _isTelemetryEnabled ) _frameTelemetry.report();
+        if( !_isStartupReported && _firstFrameTime.load(std::memory_order_acquire) != 0 ) _reportStartup();
 
-        // draw everything to the window
-        _renderScene(_pArcballCam->getViewMatrix(), _pArcballCam->getProjectionMatrix());
+        // events that changed nothing, like the cursor crossing the window, do not earn a frame
+        if( wasIdle && _isSceneIdle()
+            && (_settings.idleAnimationRate <= 0.0 || std::chrono::steady_clock::now() < nextIdleFrameTime) ) {
+            continue;
+        }
 
-        _updateScene();
+        // advance the simulation in fixed steps by however much time has passed, a headless run
+        // takes exactly one step per frame so every run draws the same frames
+        auto currentTime = std::chrono::steady_clock::now();
+        if( _settings.headless ) {
+            _advanceSimulation( 1.0 / _settings.simulationRate );
+        } else {
+            _advanceSimulation( std::chrono::duration<GLdouble>(currentTime - previousTime).count() );
+        }
+        previousTime = currentTime;
 
-        glfwSwapBuffers(mpWindow);                       // flush the OpenGL commands and make sure they get rendered!
-        glfwPollEvents();				                // check for any events and signal to redraw screen
+        if( _settings.simulationOnly && !_settings.headless ) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // place the hero and camera between the last two steps
+        _interpolateScene( (GLfloat)(_simulationAccumulator * _settings.simulationRate) );
+
+        // hand the render thread a copy of the scene to draw
+        _publishSceneSnapshot();
+        _isSceneDirty = GL_FALSE;
+        nextIdleFrameTime = currentTime + IDLE_FRAME_PERIOD;
+    }
+
+    _sceneSnapshots.close();
+    renderThread.join();
+
+    _inputRecorder.close(_simulationTick);
+
+    if( _settings.lateLatchCamera && _numLatchedFrames > 0 ) {
+        fprintf( stdout, "[INFO]: Late latch drew %llu of %llu frames (%.1f%%) with a newer camera view\n",
+                 (unsigned long long)_numLateViewsUsed, (unsigned long long)_numLatchedFrames,
+                 100.0 * (GLdouble)_numLateViewsUsed / (GLdouble)_numLatchedFrames );
+    }
+
+    // a short headless run can finish before the loop got to report it
+    if( !_isStartupReported && _firstFrameTime.load(std::memory_order_acquire) != 0 ) _reportStartup();
+    if( _isTelemetryEnabled ) _frameTelemetry.report(true);
+
+    if( _pGpuProfiler != nullptr ) _pGpuProfiler->printSummary();
+    if( Profiler::isEnabled() ) {
+        Profiler::writeChromeTrace(_settings.profileOutput.c_str());
+    }
+
+    // take the context back for shutdown
+    glfwMakeContextCurrent(mpWindow);
+
+    if( _settings.headless ) {
+        _writeBenchmarkResults();
     }
 }
 
@@ -417,11 +1397,69 @@ void A3Engine::run() {
 //
 // Private Helper FUnctions
 
+void A3Engine::_writeBenchmarkResults() const {
+    const std::string& path = _settings.benchmarkOutput;
+    const bool isJson = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+
+    FILE* pFile = fopen(path.c_str(), "w");
+    if( pFile == nullptr ) {
+        fprintf( stderr, "[ERROR]: Could not open benchmark output \"%s\"\n", path.c_str() );
+        return;
+    }
+
+    GLdouble totalCpuTime = 0.0, totalGpuTime = 0.0;
+    if( isJson ) {
+        fprintf( pFile, "{\n  \"frames\": [\n" );
+    } else {
+        fprintf( pFile, "frame,cpu_ms,gpu_ms,draw_calls,instances,triangles,uniform_uploads,uniform_bytes,program_binds,vao_binds,bytes_uploaded%s\n",
+                 _benchmarkScript.isLoaded() ? ",segment" : "" );
+    }
+    for(size_t i = 0; i < _frameTimings.size(); i++) {
+        const FrameTiming& timing = _frameTimings[i];
+        const RenderStats::Counters& stats = timing.stats;
+        if( isJson ) {
+            fprintf( pFile, "    {\"frame\": %zu, \"cpuMs\": %.4f, \"gpuMs\": %.4f, \"drawCalls\": %llu, \"instances\": %llu, \"triangles\": %llu, "
+                            "\"uniformUploads\": %llu, \"uniformBytes\": %llu, \"programBinds\": %llu, \"vaoBinds\": %llu, \"bytesUploaded\": %llu}%s\n",
+                     i, timing.cpuTime, timing.gpuTime, (unsigned long long)stats.drawCalls, (unsigned long long)stats.instances,
+                     (unsigned long long)stats.triangles, (unsigned long long)stats.uniformUploads, (unsigned long long)stats.uniformBytes,
+                     (unsigned long long)stats.programBinds, (unsigned long long)stats.vertexArrayBinds, (unsigned long long)stats.bytesUploaded,
+                     i + 1 < _frameTimings.size() ? "," : "" );
+        } else {
+            fprintf( pFile, "%zu,%.4f,%.4f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu", i, timing.cpuTime, timing.gpuTime,
+                     (unsigned long long)stats.drawCalls, (unsigned long long)stats.instances, (unsigned long long)stats.triangles,
+                     (unsigned long long)stats.uniformUploads, (unsigned long long)stats.uniformBytes, (unsigned long long)stats.programBinds,
+                     (unsigned long long)stats.vertexArrayBinds, (unsigned long long)stats.bytesUploaded );
+            if( _benchmarkScript.isLoaded() ) {
+                const GLint segmentIndex = _benchmarkScript.findSegment( (GLdouble)i / _settings.simulationRate );
+                fprintf( pFile, ",%s", segmentIndex >= 0 ? _benchmarkScript.getSegments()[segmentIndex].name.c_str() : "" );
+            }
+            fprintf( pFile, "\n" );
+        }
+        totalCpuTime += timing.cpuTime;
+        totalGpuTime += timing.gpuTime;
+    }
+    if( isJson ) {
+        fprintf( pFile, "  ]%s\n", _benchmarkScript.isLoaded() ? "," : "" );
+        _writeSegmentSummaries( pFile, true );
+        fprintf( pFile, "}\n" );
+    } else {
+        _writeSegmentSummaries( nullptr, false );
+    }
+    fclose(pFile);
+
+    const GLdouble numFrames = glm::max((GLdouble)_frameTimings.size(), 1.0);
+    fprintf( stdout, "[INFO]: Benchmark of %zu frames written to %s, average CPU %.3f ms, GPU %.3f ms\n",
+             _frameTimings.size(), path.c_str(), totalCpuTime / numFrames, totalGpuTime / numFrames );
+}
+
 void A3Engine::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
     // precompute the Model-View-Projection matrix on the CPU
     glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
     // then send it to the shader on the GPU to apply to every vertex
     _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.mvpMatrix, mvpMtx);
+    if( _lightingShaderUniformLocations.modelMatrix != -1 ) {
+        _lightingShaderProgram->setProgramUniform(_lightingShaderUniformLocations.modelMatrix, modelMtx);
+    }
 
     // TODO #7: compute and send the normal matrix
     glm::mat3 normalMtx = glm::mat3(glm::transpose(glm::inverse(modelMtx)));
@@ -429,6 +1467,43 @@ void A3Engine::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewM
 
 }
 
+void A3Engine::_writeSegmentSummaries(FILE* pFile, const bool isJson) const {
+    if( !_benchmarkScript.isLoaded() ) return;
+
+    const std::vector<BenchmarkScript::Segment>& segments = _benchmarkScript.getSegments();
+    if( isJson ) fprintf( pFile, "  \"segments\": [\n" );
+
+    std::vector<GLdouble> cpuTimes, gpuTimes;
+    for(size_t segmentIndex = 0; segmentIndex < segments.size(); segmentIndex++) {
+        // frame i shows the scene i steps into the script
+        cpuTimes.clear();
+        gpuTimes.clear();
+        for(size_t i = 0; i < _frameTimings.size(); i++) {
+            if( _benchmarkScript.findSegment( (GLdouble)i / _settings.simulationRate ) == (GLint)segmentIndex ) {
+                cpuTimes.push_back( _frameTimings[i].cpuTime );
+                gpuTimes.push_back( _frameTimings[i].gpuTime );
+            }
+        }
+
+        GLdouble cpuStats[3], gpuStats[3];
+        computeFrameTimeStats( cpuTimes, cpuStats );
+        computeFrameTimeStats( gpuTimes, gpuStats );
+
+        const char* name = segments[segmentIndex].name.c_str();
+        fprintf( stdout, "[INFO]: %-16s %5zu frames  CPU min %.3f avg %.3f p99 %.3f ms  GPU min %.3f avg %.3f p99 %.3f ms\n",
+                 name, cpuTimes.size(), cpuStats[0], cpuStats[1], cpuStats[2], gpuStats[0], gpuStats[1], gpuStats[2] );
+        if( isJson ) {
+            fprintf( pFile, "    {\"name\": \"%s\", \"frames\": %zu, "
+                            "\"cpuMs\": {\"min\": %.4f, \"avg\": %.4f, \"p99\": %.4f}, "
+                            "\"gpuMs\": {\"min\": %.4f, \"avg\": %.4f, \"p99\": %.4f}}%s\n",
+                     name, cpuTimes.size(), cpuStats[0], cpuStats[1], cpuStats[2], gpuStats[0], gpuStats[1], gpuStats[2],
+                     segmentIndex + 1 < segments.size() ? "," : "" );
+        }
+    }
+
+    if( isJson ) fprintf( pFile, "  ]\n" );
+}
+
 //*************************************************************************************
 //
 // Callbacks
@@ -452,4 +1527,18 @@ void lab05_engine_mouse_button_callback(GLFWwindow *window, int button, int acti
 
     // pass the mouse button and action through to the engine
     engine->handleMouseButtonEvent(button, action);
-}
\ No newline at end of file
+}
+
+void lab05_engine_framebuffer_size_callback(GLFWwindow *window, int width, int height ) {
+    auto engine = (A3Engine*) glfwGetWindowUserPointer(window);
+
+    // pass the new framebuffer size through to the engine
+    engine->handleFramebufferSizeEvent(width, height);
+}
+
+void lab05_engine_window_refresh_callback(GLFWwindow *window ) {
+    auto engine = (A3Engine*) glfwGetWindowUserPointer(window);
+
+    // let the engine know the window needs to be drawn again
+    engine->handleWindowRefreshEvent();
+}
@@ -3,16 +3,111 @@
 
 #include <CSCI441/FreeCam.hpp>
 #include "ArcballCam.h"
+#include "BenchmarkScript.h"
 #include <CSCI441/OpenGLEngine.hpp>
+#include <CSCI441/ShaderPermutationCache.hpp>
 #include <CSCI441/ShaderProgram.hpp>
 
+#include "FrameResources.h"
+#include "FrameTelemetry.h"
+#include "GpuProfiler.h"
 #include "Hero.h"
+#include "InputRecording.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "RenderStats.h"
+#include "RenderTarget.h"
+#include "ShaderHotReloader.h"
+#include "SnapshotBuffer.h"
+#include "TextOverlay.h"
 
+#include <atomic>
+#include <cstdio>
+#include <mutex>
+#include <string>
 #include <vector>
 
 class A3Engine final : public CSCI441::OpenGLEngine {
 public:
-    A3Engine();
+    /// \desc runtime options that control how the engine renders
+    struct Settings {
+        /// \desc number of frames the CPU may build ahead of the GPU
+        GLuint framesInFlight = 2;
+        /// \desc size in bytes of the per-frame transient buffer
+        GLsizeiptr transientBufferSize = 1 << 20;
+        /// \desc number of job system workers, 0 picks one per spare core
+        GLuint workerThreads = 0;
+        /// \desc fixed simulation steps per second of simulated time
+        GLdouble simulationRate = 60.0;
+        /// \desc most simulation steps taken per frame to catch up (scaled by timeScale)
+        GLuint maxCatchUpSteps = 5;
+        /// \desc simulated seconds per real second
+        GLdouble timeScale = 1.0;
+        /// \desc if true the scene is simulated but never handed to the renderer
+        bool simulationOnly = false;
+        /// \desc if true the render thread swaps in the newest view matrix after building its commands
+        bool lateLatchCamera = false;
+        /// \desc if true the camera is driven by raw, unaccelerated mouse motion when supported
+        bool rawMouseMotion = false;
+        /// \desc if true depth is reversed with an infinite far plane and a float depth buffer
+        bool reverseZ = false;
+        /// \desc if true nothing is redrawn while the scene is idle, the main thread sleeps on events instead
+        bool idleMode = false;
+        /// \desc frames per second the hover keeps animating at while idle, 0 pauses it until the next event
+        GLdouble idleAnimationRate = 15.0;
+        /// \desc if true an invisible window is rendered offscreen for a fixed number of frames and timed
+        bool headless = false;
+        /// \desc number of frames drawn by a headless run
+        GLuint benchmarkFrames = 600;
+        /// \desc file the headless frame times are written to, JSON if it ends in .json and CSV otherwise
+        std::string benchmarkOutput = "benchmark.csv";
+        /// \desc scripted benchmark scene to play back headless, empty for none
+        std::string benchmarkScript;
+        /// \desc file to record the session's input to, empty for none
+        std::string recordInput;
+        /// \desc recorded session to replay instead of live input, empty for none
+        std::string replayInput;
+        /// \desc seed the world is generated from, 0 picks one from the clock
+        GLuint worldSeed = 0;
+        /// \desc Chrome trace the profiler writes at exit and on F9, empty leaves the profiler off
+        std::string profileOutput;
+        /// \desc times the render passes on the GPU and prints a summary at exit, also on whenever profileOutput is set
+        bool gpuProfile = false;
+        /// \desc starts with the render stats drawn over the scene, F3 toggles them either way
+        bool statsOverlay = false;
+        /// \desc seconds between frame time percentile reports to the log, 0 leaves the telemetry off
+        GLdouble telemetryInterval = 0.0;
+        /// \desc JSON file every frame time report is also written to for a monitoring agent, empty for none
+        std::string telemetryOutput;
+        /// \desc if true edited shader files are recompiled in the background and swapped in without a restart
+        bool shaderHotReload = false;
+
+        /// \desc synthetic scene for scaling studies, its tiles replace the grid when there are any
+        struct StressScene {
+            /// \desc how the tiles are spread over the scene
+            enum class Distribution {
+                /// \desc evenly over the whole area
+                UNIFORM,
+                /// \desc in gaussian clumps around random centers
+                CLUSTERED
+            };
+
+            /// \desc number of tiles, 0 keeps the regular grid
+            GLuint numTiles = 0;
+            /// \desc number of extra, stationary heroes
+            GLuint numHeroes = 0;
+            /// \desc number of point lights, at most MAX_POINT_LIGHTS
+            GLuint numLights = 0;
+            /// \desc fraction of the scene's area covered by tiles, sets how far they spread out
+            GLfloat density = 0.25f;
+            /// \desc how the tiles are spread over the scene
+            Distribution distribution = Distribution::UNIFORM;
+            /// \desc tallest a tile can be, heights are picked uniformly below it
+            GLfloat maxTileHeight = 3.0f;
+        } stress;
+    };
+
+    explicit A3Engine(const Settings& settings = Settings());
     ~A3Engine() final;
 
     void run() final;
@@ -29,8 +124,17 @@ public:
 
     /// \desc handle any cursor movement events inside the engine
     /// \param currMousePosition the current cursor position
+    /// \note movement is only accumulated here, it is applied to the camera once per frame
     void handleCursorPositionEvent(glm::vec2 currMousePosition);
 
+    /// \desc handle the framebuffer being resized
+    /// \param width new framebuffer width in pixels
+    /// \param height new framebuffer height in pixels
+    void handleFramebufferSizeEvent(GLint width, GLint height);
+
+    /// \desc handle the window contents being damaged and needing a redraw
+    void handleWindowRefreshEvent();
+
     /// \desc value off-screen to represent mouse has not begun interacting with window yet
     static constexpr GLfloat MOUSE_UNINITIALIZED = -9999.0f;
 
@@ -38,6 +142,9 @@ public:
     glm::vec3 heroPosition;
 
 private:
+    /// \desc options the engine was created with
+    Settings _settings;
+
     // Variables used to create idle motion of hovering.
     GLfloat _yOffset;
     GLfloat _timeVariable;
@@ -52,13 +159,209 @@ private:
     void mCleanupBuffers() final;
     void mCleanupShaders() final;
 
+    /// \desc immutable copy of everything the render thread needs to draw one frame
+    struct SceneSnapshot {
+        /// \desc increasing number identifying the snapshot
+        GLuint64 snapshotNumber;
+        /// \desc camera view matrix
+        glm::mat4 viewMtx;
+        /// \desc camera projection matrix
+        glm::mat4 projMtx;
+        /// \desc orientation and zoom of the camera the view matrix was built from
+        GLfloat cameraTheta, cameraPhi, cameraRadius;
+        /// \desc point the camera orbits and looks at
+        glm::vec3 cameraLookAtPoint;
+        /// \desc up vector of the camera
+        glm::vec3 cameraUpVector;
+        /// \desc point the hero is drawn at
+        glm::vec3 heroPosition;
+        /// \desc heading of the hero
+        GLfloat heroBodyAngle;
+        /// \desc size of the framebuffer to render to
+        GLint framebufferWidth, framebufferHeight;
+        /// \desc indices into _tiles of the tiles inside the view frustum
+        std::vector<GLuint> visibleTiles;
+    };
+    /// \desc snapshots produced by the main thread and consumed by the render thread
+    SnapshotBuffer<SceneSnapshot> _sceneSnapshots;
+    /// \desc number of the most recently published snapshot
+    GLuint64 _snapshotNumber;
+
+    /// \desc newest camera orientation and zoom, updated by the main thread while the render thread builds a frame
+    struct LateView {
+        /// \desc orientation and zoom of the camera
+        GLfloat theta, phi, radius;
+        /// \desc snapshot the view belongs to
+        GLuint64 snapshotNumber;
+    } _lateView;
+    /// \desc guards _lateView
+    std::mutex _lateViewMutex;
+    /// \desc stores the camera's current orientation and zoom as the late view of the newest snapshot
+    void _publishLateViewMatrix();
+    /// \desc returns the view matrix to draw a snapshot with, the late view around the snapshot's
+    /// look at point if enabled and available
+    glm::mat4 _latchViewMatrix(const SceneSnapshot& snapshot);
+    /// \desc frames drawn with the late latch on, only touched by the render thread
+    GLuint64 _numLatchedFrames;
+    /// \desc frames whose view the late latch replaced with a newer one, only touched by the render thread
+    GLuint64 _numLateViewsUsed;
+
     /// \desc draws everything to the scene from a particular point of view
-    /// \param viewMtx the current view matrix for our camera
-    /// \param projMtx the current projection matrix for our camera
-    void _renderScene(glm::mat4 viewMtx, glm::mat4 projMtx) const;
-    /// \desc handles moving our FreeCam as determined by keyboard input
+    /// \param snapshot the scene state to draw
+    void _renderScene(const SceneSnapshot& snapshot);
+    /// \desc advances the hero by one fixed simulation step as determined by keyboard input
     void _updateScene();
 
+    /// \desc state of the scene that is blended between simulation steps
+    struct SimulationState {
+        /// \desc position of the hero
+        glm::vec3 heroPosition;
+        /// \desc heading of the hero
+        GLfloat heroBodyAngle;
+    };
+    /// \desc state after the second most recent simulation step
+    SimulationState _previousState;
+    /// \desc state after the most recent simulation step
+    SimulationState _currentState;
+    /// \desc state interpolated for the frame being built
+    SimulationState _renderState;
+    /// \desc simulated time that has passed but not yet been stepped, in seconds
+    GLdouble _simulationAccumulator;
+    /// \desc number of simulation steps taken since start
+    GLuint64 _simulationTick;
+
+    /// \desc runs as many fixed simulation steps as fit into the elapsed time
+    /// \param elapsedSeconds real time since the last call
+    /// \return number of steps taken
+    GLuint _advanceSimulation(GLdouble elapsedSeconds);
+    /// \desc blends the last two simulation states and moves the camera to match
+    /// \param alpha fraction of a step the accumulator is past the current state
+    void _interpolateScene(GLfloat alpha);
+
+    /// \desc true if something changed since the last snapshot that has to be drawn right away
+    /// \note only touched by the main thread
+    GLboolean _isSceneDirty;
+    /// \desc true if nothing but the hover is moving, nothing has changed since the last snapshot
+    /// and no recompiled shader is waiting to be swapped in
+    [[nodiscard]] bool _isSceneIdle() const;
+    /// \desc copies the current scene state into the next snapshot and publishes it
+    void _publishSceneSnapshot();
+    /// \desc body of the render thread, owns the OpenGL context while running
+    void _renderLoop();
+    /// \desc size of the framebuffer as last reported by GLFW
+    glm::ivec2 _framebufferSize;
+    /// \desc true if reversed-Z was requested and clip control is available
+    GLboolean _isReverseZEnabled;
+    /// \desc offscreen target the scene is drawn into when the default framebuffer will not do
+    RenderTarget* _pSceneTarget;
+    /// \desc GPU timings of the render passes, null unless GPU profiling is on
+    GpuProfiler* _pGpuProfiler;
+    /// \desc draws the render stats over the scene
+    TextOverlay* _pTextOverlay;
+    /// \desc true while the render stats are drawn, toggled by the main thread and read by the render thread
+    std::atomic<bool> _isStatsOverlayVisible;
+    /// \desc queues and draws the render stats of the last frame over the scene
+    /// \param width width of the viewport in pixels
+    /// \param height height of the viewport in pixels
+    /// \param cpuFrameTime milliseconds the render thread spent on the last frame
+    void _drawStatsOverlay(GLint width, GLint height, GLdouble cpuFrameTime);
+    /// \desc updates the viewport and any render targets that depend on the framebuffer size
+    /// \param width new framebuffer width in pixels
+    /// \param height new framebuffer height in pixels
+    /// \note called on the render thread, only when the size changes
+    void _resizeRenderTargets(GLint width, GLint height);
+
+    /// \desc timings of one frame drawn by a headless run
+    struct FrameTiming {
+        /// \desc milliseconds the render thread spent building and submitting the frame
+        GLdouble cpuTime;
+        /// \desc milliseconds the GPU spent executing the frame
+        GLdouble gpuTime;
+        /// \desc work the frame handed to OpenGL
+        RenderStats::Counters stats;
+    };
+    /// \desc timings of each headless frame indexed by frame number, written by the render thread
+    /// and read by the main thread once it has been joined
+    std::vector<FrameTiming> _frameTimings;
+    /// \desc percentiles of the CPU, GPU and present time of every frame, reported periodically
+    FrameTelemetry _frameTelemetry;
+    /// \desc true if frame times are recorded into the telemetry
+    bool _isTelemetryEnabled;
+    /// \desc writes the headless frame timings to the benchmark output file
+    void _writeBenchmarkResults() const;
+
+    /// \desc camera path, hero motion and world of a scripted benchmark
+    BenchmarkScript _benchmarkScript;
+    /// \desc sets the movement keys the script holds down at a simulation step
+    /// \param time seconds of simulated time since the start of the script
+    void _applyScriptedHero(GLdouble time);
+    /// \desc moves the camera to where the script has it
+    /// \param time seconds of simulated time since the start of the script
+    void _applyScriptedCamera(GLdouble time);
+    /// \desc prints and writes min, average and 99th percentile frame times for each script segment
+    /// \param pFile open benchmark output, or nullptr to only print
+    /// \param isJson true to write the segments as a JSON array
+    void _writeSegmentSummaries(FILE* pFile, bool isJson) const;
+    /// \desc collects the tiles that intersect the view frustum, widened by as far as the late
+    /// latch can turn and zoom the camera when it is enabled
+    /// \param viewProjMtx combined view and projection matrix of the camera
+    /// \param lookAtPoint point the camera orbits
+    /// \param visibleTiles list to fill with indices of the visible tiles
+    void _cullTiles(const glm::mat4& viewProjMtx, const glm::vec3& lookAtPoint, std::vector<GLuint>& visibleTiles);
+    /// \desc per-job visible lists reused by _cullTiles, only touched by the main thread
+    std::vector< std::vector<GLuint> > _cullingChunkResults;
+
+    /// \desc worker pool that engine stages split their loops across
+    JobSystem* _pJobSystem;
+
+    /// \desc a timed phase of startup
+    struct StartupPhase {
+        /// \desc name shown in the report
+        const char* name;
+        /// \desc profiler time, nanoseconds since launch, the phase began at
+        int64_t start;
+        /// \desc profiler time the phase ended at
+        int64_t end;
+        /// \desc true if the phase ran on a worker alongside the main thread
+        bool isBackground;
+    };
+    /// \desc phases of startup in the order they ended, only touched by the main thread
+    std::vector<StartupPhase> _startupPhases;
+    /// \desc tracks the CPU-only setup the workers run while the window, context and shaders are created
+    JobSystem::Counter _backgroundSetupJobs;
+    /// \desc when the environment was generated, written by its job and read once the job is done
+    StartupPhase _environmentPhase;
+    /// \desc when the shader sources were read ahead, written by its job and read once the job is done
+    StartupPhase _shaderPrefetchPhase;
+    /// \desc profiler time run() began at
+    int64_t _runStartTime;
+    /// \desc profiler time the first frame was finished at, 0 until it has been
+    std::atomic<int64_t> _firstFrameTime;
+    /// \desc true once the startup breakdown has been reported
+    bool _isStartupReported;
+    /// \desc starts the setup that needs no OpenGL context on the workers
+    void _startBackgroundSetup();
+    /// \desc waits for the background setup and adds its phases to the breakdown
+    void _finishBackgroundSetup();
+    /// \desc adds a phase of the main thread's startup that ends now
+    /// \param name name shown in the report, must be a string that lives for the whole run
+    /// \param start profiler time the phase began at
+    void _endStartupPhase(const char* name, int64_t start);
+    /// \desc logs how long each phase of startup took and how long it took to finish the first frame
+    void _reportStartup();
+
+    /// \desc uniforms for one tile draw, built in parallel before the draws are issued
+    struct TileDrawCommand {
+        /// \desc model matrix, combined with the latched view when the draw is issued
+        glm::mat4 modelMtx;
+        /// \desc precomputed normal matrix
+        glm::mat3 normalMtx;
+        /// \desc material diffuse color
+        glm::vec3 color;
+    };
+    /// \desc draw commands for the visible tiles, only touched by the render thread
+    std::vector<TileDrawCommand> _tileDrawCommands;
+
     /// \desc tracks the number of different keys that can be present as determined by GLFW
     static constexpr GLuint NUM_KEYS = GLFW_KEY_LAST;
     /// \desc boolean array tracking each key state.  if true, then the key is in a pressed or held
@@ -69,6 +372,27 @@ private:
     glm::vec2 _mousePosition;
     /// \desc current state of the left mouse button
     GLint _leftMouseButtonState;
+    /// \desc true if raw mouse motion was requested and is supported
+    GLboolean _isRawMouseMotionEnabled;
+
+    /// \desc camera movement accumulated from cursor events since the last frame
+    struct CameraInput {
+        /// \desc rotation around the look at point
+        GLfloat dTheta;
+        /// \desc rotation towards or away from the poles
+        GLfloat dPhi;
+        /// \desc net number of zoom steps, positive moves forward
+        GLint zoomSteps;
+    } _pendingCameraInput;
+    /// \desc applies and clears the accumulated camera movement
+    void _applyCameraInput();
+
+    /// \desc writes every handled input event when recording a session
+    InputRecorder _inputRecorder;
+    /// \desc feeds a recorded session back in place of live input
+    InputReplayer _inputReplayer;
+    /// \desc hands the recorded events due at the current simulation tick to the input handlers
+    void _replayInput();
 
     /// \desc the static fixed camera in our world
     CSCI441::ArcballCam* _pArcballCam;
@@ -79,6 +403,9 @@ private:
     /// \desc our hero model
     Hero* _pHero;
 
+    /// \desc fences, transient buffers and queries for each frame in flight
+    FrameResources* _pFrameResources;
+
     /// \desc the size of the world (controls the ground size and locations of tiles)
     static constexpr GLfloat WORLD_SIZE = 55.0f;
     /// \desc VAO for our ground
@@ -95,14 +422,53 @@ private:
         glm::mat4 modelMatrix;
         /// \desc color to draw the tiles
         glm::vec3 color;
+        /// \desc world space center of the tile's bounding sphere
+        glm::vec3 boundingCenter;
+        /// \desc radius of the tile's bounding sphere
+        GLfloat boundingRadius;
     };
     /// \desc information list of all the tiles to draw
     std::vector<TileData> _tiles;
 
     /// \desc generates tiles information to make up our scene
     void _generateEnvironment();
+    /// \desc builds a tile standing on a spot of the ground
+    /// \param spot position on the ground
+    /// \param height height of the tile
+    /// \param color color of the tile
+    static TileData _makeTile(const glm::vec3& spot, GLfloat height, const glm::vec3& color);
+    /// \desc generates the tiles of a stress scene in place of the grid
+    void _generateStressTiles();
+    /// \desc generates the extra heroes and the point lights of a stress scene
+    void _generateStressActors();
+
+    /// \desc a stationary hero added by a stress scene
+    struct StressHero {
+        /// \desc where the hero stands
+        glm::vec3 position;
+        /// \desc heading of the hero
+        GLfloat bodyAngle;
+    };
+    /// \desc extra heroes of a stress scene
+    std::vector<StressHero> _stressHeroes;
 
-    /// \desc shader program that performs lighting
+    /// \desc most point lights the lighting shader supports, must match the vertex shader
+    static constexpr GLuint MAX_POINT_LIGHTS = 64;
+    /// \desc world space positions of the point lights
+    std::vector<glm::vec3> _pointLightPositions;
+    /// \desc colors of the point lights
+    std::vector<glm::vec3> _pointLightColors;
+
+    /// \desc features the lighting shader can be specialised with, in the order of their defines
+    enum LightingFeature : CSCI441::ShaderPermutationCache::FeatureMask {
+        /// \desc adds the point lights of a stress scene
+        LIGHTING_POINT_LIGHTS = 1 << 0
+    };
+    /// \desc variants of the lighting shader, compiled as they are first needed
+    CSCI441::ShaderPermutationCache* _pLightingShaders;
+    /// \desc features of the lighting shader the scene needs
+    CSCI441::ShaderPermutationCache::FeatureMask _lightingFeatures;
+    /// \desc shader program that performs lighting, the variant with the scene's features
     CSCI441::ShaderProgram* _lightingShaderProgram = nullptr;   // the wrapper for our shader program
     /// \desc stores the locations of all of our shader uniforms
     struct LightingShaderUniformLocations {
@@ -114,7 +480,14 @@ private:
         GLint normalMatrix;
         GLint lightDirection;
         GLint lightColor;
-
+        /// \desc model matrix location, places vertices relative to the point lights
+        GLint modelMatrix;
+        /// \desc number of point lights location
+        GLint numPointLights;
+        /// \desc point light position array location
+        GLint pointLightPositions;
+        /// \desc point light color array location
+        GLint pointLightColors;
 
     } _lightingShaderUniformLocations;
     /// \desc stores the locations of all of our shader attributes
@@ -125,6 +498,17 @@ private:
         GLint vertexNormal;
 
     } _lightingShaderAttributeLocations;
+    /// \desc looks up the uniform locations of the lighting shader program
+    void _lookupLightingShaderUniforms();
+    /// \desc sends the lighting uniforms that never change, the light colors and directions
+    void _sendLightingUniforms() const;
+
+    /// \desc recompiles the shaders when their files change, null unless hot reload is on
+    ShaderHotReloader* _pShaderHotReloader;
+    /// \desc puts a recompiled lighting shader program in place of the current one
+    /// \param pShaderProgram linked program compiled with the scene's lighting features
+    /// \note called on the render thread between frames
+    void _swapLightingShaderProgram(CSCI441::ShaderProgram* pShaderProgram);
 
     /// \desc precomputes the matrix uniforms CPU-side and then sends them
     /// to the GPU to be used in the shader for each vertex.  It is more efficient
@@ -138,5 +522,7 @@ private:
 void lab05_engine_keyboard_callback(GLFWwindow *window, int key, int scancode, int action, int mods );
 void lab05_engine_cursor_callback(GLFWwindow *window, double x, double y );
 void lab05_engine_mouse_button_callback(GLFWwindow *window, int button, int action, int mods );
+void lab05_engine_framebuffer_size_callback(GLFWwindow *window, int width, int height );
+void lab05_engine_window_refresh_callback(GLFWwindow *window );
 
 #endif// LAB05_LAB05_ENGINE_H
@@ -19,6 +19,8 @@
 
 #include "CSCI441/Camera.hpp"
 
+#include "Profiler.h"
+
 namespace CSCI441 {
 
     /**
@@ -40,27 +42,67 @@ namespace CSCI441 {
         explicit ArcballCam(GLfloat minRadius = 2.0f, GLfloat maxRadius = 35.0f, GLfloat aspectRatio = 1.0f, GLfloat fovy = 45.0f, GLfloat nearClipPlane = 0.001f, GLfloat farClipPlane = 1000.0f);
 
         /**
-         * @brief converts spherical theta & phi to cartesian x,y,z direction vector
-         * @note sets the camera's position to be on a sphere centered at the camera's
-         * look at position
-         * @note internally sets the camera's view matrix
+         * @brief marks the orientation as changed after theta, phi, radius or the look at point were set
+         * @note the cartesian direction, the camera's position and its view matrix are
+         * recomputed on the next call to getViewMatrix(), so any number of changes in a
+         * frame cost a single recomputation
          */
         void recomputeOrientation() final;
 
         /**
          * @brief updates the camera's position by decreasing the camera's radius
          * @param movementFactor distance factor to scale the movement step
-         * @note internally sets the camera's view matrix
+         * @note marks the camera's view matrix as out of date
          */
         void moveForward(GLfloat movementFactor) final;
 
         /**
          * @brief updates the camera's position by increasing the camera's radius
          * @param movementFactor distance factor to scale the movement step
-         * @note internally sets the camera's view matrix
+         * @note marks the camera's view matrix as out of date
          */
         void moveBackward(GLfloat movementFactor) final;
 
+        /**
+         * @brief returns the view matrix, recomputing it first if the orientation changed
+         * @return homogeneous view matrix
+         * @note getPosition() returns the last computed position until this is called
+         */
+        [[nodiscard]] glm::mat4 getViewMatrix();
+
+        /**
+         * @brief builds the view matrix of an arcball orientation without changing the camera
+         * @param theta angle of the camera around the up axis
+         * @param phi angle of the camera down from the up axis
+         * @param radius distance of the camera from the look at point
+         * @param lookAtPoint point the camera orbits and looks at
+         * @param upVector up vector of the camera
+         * @return homogeneous view matrix
+         */
+        [[nodiscard]] static glm::mat4 computeOrbitViewMatrix(GLfloat theta, GLfloat phi, GLfloat radius, const glm::vec3& lookAtPoint, const glm::vec3& upVector);
+
+        /**
+         * @brief returns the projection matrix, recomputing it first if its parameters changed
+         * @return homogeneous projection matrix
+         */
+        [[nodiscard]] glm::mat4 getProjectionMatrix();
+
+        /**
+         * @brief sets the aspect ratio of the view plane
+         * @param aspectRatio width divided by height of the view plane
+         * @note the projection matrix is recomputed on the next call to getProjectionMatrix()
+         */
+        void setAspectRatio(GLfloat aspectRatio);
+
+        /**
+         * @brief switches between a standard projection and a reversed-Z projection with an infinite far plane
+         * @param reversedDepth true to map the near plane to depth 1 and infinity to depth 0
+         * @note the reversed projection expects a [0,1] clip depth range (glClipControl with
+         * GL_ZERO_TO_ONE), a GL_GREATER depth test and a depth clear value of 0
+         * @note the far clip plane is ignored while the reversed projection is used
+         */
+        void setReversedDepth(GLboolean reversedDepth);
+
     private:
         /**
          * @brief updates the camera position and recalculates the view matrix
@@ -72,6 +114,21 @@ namespace CSCI441 {
          */
         void _clampRadius();
 
+        /**
+         * @brief converts an arcball orientation from spherical to cartesian coordinates
+         * @return vector from the look at point to the camera
+         */
+        [[nodiscard]] static glm::vec3 _computeDirection(GLfloat theta, GLfloat phi, GLfloat radius);
+
+        /**
+         * @brief true if the view matrix is out of date
+         */
+        GLboolean _isOrientationDirty;
+        /**
+         * @brief true if the projection matrix is out of date
+         */
+        GLboolean _isProjectionDirty;
+
         /**
          * @brief minimum allowable radius of camera
          */
@@ -98,6 +155,10 @@ namespace CSCI441 {
          * @brief far Z clipping plane
          */
         GLfloat _farClipPlane;
+        /**
+         * @brief true if the projection is reversed-Z with an infinite far plane
+         */
+        GLboolean _isReversedDepth;
     };
 }
 
@@ -108,23 +169,20 @@ inline CSCI441::ArcballCam::ArcballCam(
         const GLfloat fovy,
         const GLfloat nearClipPlane,
         const GLfloat farClipPlane
-) : _minRadius(minRadius),
+) : _isOrientationDirty(GL_TRUE),
+    _isProjectionDirty(GL_TRUE),
+    _minRadius(minRadius),
     _maxRadius(maxRadius),
     _fovy(fovy),
     _aspectRatio(aspectRatio),
     _nearClipPlane(nearClipPlane),
-    _farClipPlane(farClipPlane)
+    _farClipPlane(farClipPlane),
+    _isReversedDepth(GL_FALSE)
 {
-    mProjectionMatrix = glm::perspective(_fovy, _aspectRatio, _nearClipPlane, _farClipPlane);
 }
 
 inline void CSCI441::ArcballCam::recomputeOrientation() {
-    // compute direction vector based on spherical to cartesian conversion
-    mCameraDirection.x =  glm::sin(mCameraTheta ) * glm::sin(mCameraPhi ) * mCameraRadius;
-    mCameraDirection.y = -glm::cos(mCameraPhi )                                  * mCameraRadius;
-    mCameraDirection.z = -glm::cos(mCameraTheta ) * glm::sin(mCameraPhi ) * mCameraRadius;
-
-    _updateArcballCameraViewMatrix();
+    _isOrientationDirty = GL_TRUE;      // deferred until the view matrix is needed
 }
 
 inline void CSCI441::ArcballCam::moveForward(const GLfloat movementFactor) {
@@ -139,6 +197,61 @@ inline void CSCI441::ArcballCam::moveBackward(const GLfloat movementFactor) {
     recomputeOrientation();             // update view matrix
 }
 
+inline glm::mat4 CSCI441::ArcballCam::getViewMatrix() {
+    if( _isOrientationDirty ) {
+        A3_PROFILE_SCOPE("ArcballCam::updateViewMatrix");
+
+        mCameraDirection = _computeDirection(mCameraTheta, mCameraPhi, mCameraRadius);
+
+        _updateArcballCameraViewMatrix();
+        _isOrientationDirty = GL_FALSE;
+    }
+    return mViewMatrix;
+}
+
+inline glm::mat4 CSCI441::ArcballCam::computeOrbitViewMatrix(
+        const GLfloat theta,
+        const GLfloat phi,
+        const GLfloat radius,
+        const glm::vec3& lookAtPoint,
+        const glm::vec3& upVector
+) {
+    return glm::lookAt(lookAtPoint + _computeDirection(theta, phi, radius), lookAtPoint, upVector);
+}
+
+inline glm::mat4 CSCI441::ArcballCam::getProjectionMatrix() {
+    if( _isProjectionDirty ) {
+        if( _isReversedDepth ) {
+            // z_clip = near and w_clip = -z_eye, so depth is near / -z_eye: 1 at the near
+            // plane, approaching 0 at infinity, with float precision spread evenly across the range
+            const GLfloat focalLength = 1.0f / glm::tan(_fovy / 2.0f);
+            mProjectionMatrix = glm::mat4(0.0f);
+            mProjectionMatrix[0][0] = focalLength / _aspectRatio;
+            mProjectionMatrix[1][1] = focalLength;
+            mProjectionMatrix[2][3] = -1.0f;
+            mProjectionMatrix[3][2] = _nearClipPlane;
+        } else {
+            mProjectionMatrix = glm::perspective(_fovy, _aspectRatio, _nearClipPlane, _farClipPlane);
+        }
+        _isProjectionDirty = GL_FALSE;
+    }
+    return mProjectionMatrix;
+}
+
+inline void CSCI441::ArcballCam::setAspectRatio(const GLfloat aspectRatio) {
+    if( aspectRatio != _aspectRatio ) {
+        _aspectRatio = aspectRatio;
+        _isProjectionDirty = GL_TRUE;
+    }
+}
+
+inline void CSCI441::ArcballCam::setReversedDepth(const GLboolean reversedDepth) {
+    if( reversedDepth != _isReversedDepth ) {
+        _isReversedDepth = reversedDepth;
+        _isProjectionDirty = GL_TRUE;
+    }
+}
+
 inline void CSCI441::ArcballCam::_updateArcballCameraViewMatrix() {
     setPosition(mCameraLookAtPoint + mCameraDirection );
     computeViewMatrix();
@@ -148,4 +261,11 @@ inline void CSCI441::ArcballCam::_clampRadius() {
     mCameraRadius = glm::clamp(mCameraRadius, _minRadius, _maxRadius);
 }
 
+inline glm::vec3 CSCI441::ArcballCam::_computeDirection(const GLfloat theta, const GLfloat phi, const GLfloat radius) {
+    // compute direction vector based on spherical to cartesian conversion
+    return glm::vec3( glm::sin(theta) * glm::sin(phi) * radius,
+                     -glm::cos(phi)                   * radius,
+                     -glm::cos(theta) * glm::sin(phi) * radius);
+}
+
 #endif //A3_ARCBALLCAM_H
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "BenchmarkScript.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+bool BenchmarkScript::load(const char* path) {
+    _segments.clear();
+    _worldParameters = WorldParameters();
+
+    FILE* pFile = fopen(path, "r");
+    if(pFile == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not open benchmark script \"%s\"\n", path);
+        return false;
+    }
+
+    GLdouble segmentStart = 0.0;
+    char line[512];
+    int lineNumber = 0;
+    bool isValid = true;
+    while(fgets(line, sizeof(line), pFile) != nullptr) {
+        lineNumber++;
+
+        // strip comments, then skip anything left blank
+        char* pComment = strchr(line, '#');
+        if(pComment != nullptr) *pComment = '\0';
+        char command[32];
+        if(sscanf(line, "%31s", command) != 1) continue;
+
+        const char* pArguments = strstr(line, command) + strlen(command);
+        if(strcmp(command, "world") == 0) {
+            if(sscanf(pArguments, "%f %f %f", &_worldParameters.gridWidth, &_worldParameters.gridLength, &_worldParameters.gridSpacing) != 3
+               || _worldParameters.gridSpacing < 1.0f) {
+                // tiles sit on whole units, so the spacing cannot be below one
+                fprintf(stderr, "[ERROR]: %s:%d: expected world <grid width> <grid length> <grid spacing of at least 1>\n", path, lineNumber);
+                isValid = false;
+            }
+        } else if(strcmp(command, "segment") == 0) {
+            char name[128];
+            GLdouble duration = 0.0;
+            if(sscanf(pArguments, "%127s %lf", name, &duration) != 2 || duration <= 0.0) {
+                fprintf(stderr, "[ERROR]: %s:%d: expected segment <name> <duration>\n", path, lineNumber);
+                isValid = false;
+                continue;
+            }
+            if(!_segments.empty()) segmentStart += _segments.back().duration;
+            _segments.push_back({name, segmentStart, duration, {}, {}});
+        } else if(_segments.empty()) {
+            fprintf(stderr, "[ERROR]: %s:%d: %s before the first segment\n", path, lineNumber, command);
+            isValid = false;
+        } else if(strcmp(command, "camera") == 0) {
+            CameraKey key = {0.0, 0.0f, 0.0f, 0.0f, GL_FALSE, glm::vec3(0.0f)};
+            const int numRead = sscanf(pArguments, "%lf %f %f %f %f %f %f", &key.time, &key.theta, &key.phi, &key.radius,
+                                       &key.lookAtPoint.x, &key.lookAtPoint.y, &key.lookAtPoint.z);
+            if(numRead != 4 && numRead != 7) {
+                fprintf(stderr, "[ERROR]: %s:%d: expected camera <time> <theta> <phi> <radius> [<x> <y> <z>]\n", path, lineNumber);
+                isValid = false;
+                continue;
+            }
+            key.time += _segments.back().startTime;
+            key.theta = glm::radians(key.theta);
+            key.phi = glm::radians(key.phi);
+            key.hasLookAtPoint = numRead == 7 ? GL_TRUE : GL_FALSE;
+            _segments.back().cameraKeys.push_back(key);
+        } else if(strcmp(command, "hero") == 0) {
+            HeroKey key = {0.0, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE};
+            char keys[8];
+            if(sscanf(pArguments, "%lf %7s", &key.time, keys) != 2) {
+                fprintf(stderr, "[ERROR]: %s:%d: expected hero <time> <keys>\n", path, lineNumber);
+                isValid = false;
+                continue;
+            }
+            key.time += _segments.back().startTime;
+            key.forward  = strpbrk(keys, "Ww") != nullptr;
+            key.backward = strpbrk(keys, "Ss") != nullptr;
+            key.left     = strpbrk(keys, "Aa") != nullptr;
+            key.right    = strpbrk(keys, "Dd") != nullptr;
+            _segments.back().heroKeys.push_back(key);
+        } else {
+            fprintf(stderr, "[ERROR]: %s:%d: unknown command \"%s\"\n", path, lineNumber, command);
+            isValid = false;
+        }
+    }
+    fclose(pFile);
+
+    if(!isValid || _segments.empty()) {
+        if(isValid) fprintf(stderr, "[ERROR]: Benchmark script \"%s\" has no segments\n", path);
+        _segments.clear();
+        return false;
+    }
+
+    // keys may be written in any order
+    for(Segment& segment : _segments) {
+        std::stable_sort(segment.cameraKeys.begin(), segment.cameraKeys.end(),
+                         [](const CameraKey& a, const CameraKey& b) { return a.time < b.time; });
+        std::stable_sort(segment.heroKeys.begin(), segment.heroKeys.end(),
+                         [](const HeroKey& a, const HeroKey& b) { return a.time < b.time; });
+    }
+
+    fprintf(stdout, "[INFO]: Loaded benchmark script \"%s\" with %zu segment(s), %.2f seconds\n", path, _segments.size(), getDuration());
+    return true;
+}
+
+GLdouble BenchmarkScript::getDuration() const {
+    if(_segments.empty()) return 0.0;
+    return _segments.back().startTime + _segments.back().duration;
+}
+
+GLint BenchmarkScript::findSegment(const GLdouble time) const {
+    for(size_t i = 0; i < _segments.size(); i++) {
+        if(time >= _segments[i].startTime && time < _segments[i].startTime + _segments[i].duration) return (GLint)i;
+    }
+    return -1;
+}
+
+bool BenchmarkScript::sampleCamera(const GLdouble time, CameraKey& key) const {
+    const GLint segmentIndex = findSegment(time);
+    if(segmentIndex < 0) return false;
+
+    const std::vector<CameraKey>& keys = _segments[segmentIndex].cameraKeys;
+    if(keys.empty()) return false;
+
+    // hold the first and last keys outside of their range
+    if(time <= keys.front().time) { key = keys.front(); key.time = time; return true; }
+    if(time >= keys.back().time)  { key = keys.back();  key.time = time; return true; }
+
+    size_t next = 1;
+    while(keys[next].time < time) next++;
+    const CameraKey& from = keys[next - 1];
+    const CameraKey& to = keys[next];
+    const GLfloat alpha = (GLfloat)((time - from.time) / glm::max(to.time - from.time, 1e-9));
+
+    key.time = time;
+    key.theta = glm::mix(from.theta, to.theta, alpha);
+    key.phi = glm::mix(from.phi, to.phi, alpha);
+    key.radius = glm::mix(from.radius, to.radius, alpha);
+    key.hasLookAtPoint = from.hasLookAtPoint && to.hasLookAtPoint ? GL_TRUE : GL_FALSE;
+    key.lookAtPoint = glm::mix(from.lookAtPoint, to.lookAtPoint, alpha);
+    return true;
+}
+
+BenchmarkScript::HeroKey BenchmarkScript::sampleHero(const GLdouble time) const {
+    HeroKey held = {time, GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE};
+
+    const GLint segmentIndex = findSegment(time);
+    if(segmentIndex < 0) return held;
+
+    // keys are held until the next hero key replaces them
+    for(const HeroKey& key : _segments[segmentIndex].heroKeys) {
+        if(key.time > time) break;
+        held = key;
+    }
+    held.time = time;
+    return held;
+}
@@ -0,0 +1,99 @@
+#ifndef A3_BENCHMARK_SCRIPT_H
+#define A3_BENCHMARK_SCRIPT_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/// \desc a benchmark scene read from a text file: the world to generate and a sequence of
+/// named segments, each with keyframes for the camera and for the keys driving the hero.
+///
+/// one command per line, '#' starts a comment, times are seconds from the start of the segment:
+///     world <grid width> <grid length> <grid spacing>
+///     segment <name> <duration>
+///     camera <time> <theta> <phi> <radius> [<look at x> <look at y> <look at z>]
+///     hero <time> <held keys out of WASD, or - for none>
+/// angles are in degrees.  a camera key without a look at point keeps following the hero.
+class BenchmarkScript {
+public:
+    /// \desc where the camera is at a point in time
+    struct CameraKey {
+        /// \desc seconds since the start of the script
+        GLdouble time;
+        /// \desc rotation around the look at point in radians
+        GLfloat theta;
+        /// \desc rotation from the pole in radians
+        GLfloat phi;
+        /// \desc distance from the look at point
+        GLfloat radius;
+        /// \desc true if the key sets the look at point instead of following the hero
+        GLboolean hasLookAtPoint;
+        /// \desc point the camera looks at
+        glm::vec3 lookAtPoint;
+    };
+    /// \desc which movement keys are held from a point in time on
+    struct HeroKey {
+        /// \desc seconds since the start of the script
+        GLdouble time;
+        /// \desc W, S, A and D held down
+        GLboolean forward, backward, left, right;
+    };
+    /// \desc a named stretch of the benchmark that is reported on separately
+    struct Segment {
+        /// \desc name used in the report
+        std::string name;
+        /// \desc seconds since the start of the script
+        GLdouble startTime;
+        /// \desc length in seconds
+        GLdouble duration;
+        /// \desc camera keyframes in time order
+        std::vector<CameraKey> cameraKeys;
+        /// \desc hero keyframes in time order
+        std::vector<HeroKey> heroKeys;
+    };
+    /// \desc parameters the environment is generated with
+    struct WorldParameters {
+        /// \desc extent of the tile grid along X
+        GLfloat gridWidth = 100.0f;
+        /// \desc extent of the tile grid along Z
+        GLfloat gridLength = 100.0f;
+        /// \desc distance between grid cells, at least 1
+        GLfloat gridSpacing = 1.0f;
+    };
+
+    /// \desc reads a script, replacing anything loaded before
+    /// \param path file to read
+    /// \return true if the file was read and has at least one segment
+    bool load(const char* path);
+
+    /// \desc true if a script has been loaded
+    [[nodiscard]] bool isLoaded() const { return !_segments.empty(); }
+    /// \desc total length of all segments in seconds
+    [[nodiscard]] GLdouble getDuration() const;
+    /// \desc the segments in playback order
+    [[nodiscard]] const std::vector<Segment>& getSegments() const { return _segments; }
+    /// \desc the world the script expects
+    [[nodiscard]] const WorldParameters& getWorldParameters() const { return _worldParameters; }
+
+    /// \desc finds the segment playing at a point in time
+    /// \return index of the segment, or -1 if the time is outside the script
+    [[nodiscard]] GLint findSegment(GLdouble time) const;
+    /// \desc interpolates the camera keys of the segment playing at a point in time
+    /// \param time seconds since the start of the script
+    /// \param key filled with the camera state
+    /// \return false if the segment does not move the camera
+    bool sampleCamera(GLdouble time, CameraKey& key) const;
+    /// \desc returns the movement keys held at a point in time, none before the first key of a segment
+    [[nodiscard]] HeroKey sampleHero(GLdouble time) const;
+
+private:
+    /// \desc the segments in playback order
+    std::vector<Segment> _segments;
+    /// \desc the world the script expects
+    WorldParameters _worldParameters;
+};
+
+#endif //A3_BENCHMARK_SCRIPT_H
@@ -0,0 +1,142 @@
+#include "FrameResources.h"
+#include "RenderStats.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+FrameResources::FrameResources(GLuint numFramesInFlight, GLsizeiptr transientBufferSize) {
+    if(numFramesInFlight < 1) numFramesInFlight = 1;
+
+    _frames.resize(numFramesInFlight);
+    _currentFrame = 0;
+    _transientBufferSize = transientBufferSize;
+    _frameNumber = 0;
+    _lastGpuFrameTime = 0;
+    _totalFenceWaitTime = 0;
+
+    for(Frame& frame : _frames) {
+        frame.fence = nullptr;
+        frame.transientOffset = 0;
+        frame.queryPending = GL_FALSE;
+        frame.frameNumber = 0;
+
+        glGenBuffers(1, &frame.transientBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, frame.transientBuffer);
+        glBufferData(GL_ARRAY_BUFFER, _transientBufferSize, nullptr, GL_STREAM_DRAW);
+
+        glGenQueries(1, &frame.timeElapsedQuery);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    fprintf(stdout, "[INFO]: Using %u frame(s) in flight\n", numFramesInFlight);
+}
+
+FrameResources::~FrameResources() {
+    for(Frame& frame : _frames) {
+        if(frame.fence != nullptr) glDeleteSync(frame.fence);
+        glDeleteBuffers(1, &frame.transientBuffer);
+        glDeleteQueries(1, &frame.timeElapsedQuery);
+    }
+}
+
+FrameResources::Frame& FrameResources::beginFrame() {
+    _currentFrame = (GLuint)(_frameNumber % _frames.size());
+    Frame& frame = _frames[_currentFrame];
+
+    // the GPU may still be executing the frame that last used this slot
+    _waitForFrame(frame);
+
+    // the fence has passed so the query result is ready, this will not stall
+    _readGpuTime(frame);
+
+    frame.transientOffset = 0;
+    frame.frameNumber = _frameNumber;
+
+    glBeginQuery(GL_TIME_ELAPSED, frame.timeElapsedQuery);
+
+    return frame;
+}
+
+void FrameResources::endFrame() {
+    Frame& frame = _frames[_currentFrame];
+
+    glEndQuery(GL_TIME_ELAPSED);
+    frame.queryPending = GL_TRUE;
+
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    _frameNumber++;
+}
+
+void FrameResources::retireAll() {
+    const GLuint numFrames = (GLuint)_frames.size();
+    for(GLuint i = 0; i < numFrames; i++) {
+        // the slot after the most recent frame holds the oldest one
+        Frame& frame = _frames[(_frameNumber + i) % numFrames];
+        _waitForFrame(frame);
+        _readGpuTime(frame);
+    }
+}
+
+GLintptr FrameResources::uploadTransient(const void* data, GLsizeiptr size, GLsizeiptr alignment) {
+    Frame& frame = _frames[_currentFrame];
+
+    GLsizeiptr offset = frame.transientOffset;
+    if(alignment > 1) offset = (offset + alignment - 1) / alignment * alignment;
+    if(offset + size > _transientBufferSize) {
+        fprintf(stderr, "[ERROR]: Transient buffer overflow, %ld bytes requested with %ld remaining\n",
+                (long)size, (long)(_transientBufferSize - offset));
+        return -1;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, frame.transientBuffer);
+    void* pDestination = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+                                          GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    if(pDestination == nullptr) {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return -1;
+    }
+    memcpy(pDestination, data, size);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    RenderStats::countBufferUpload(size);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    frame.transientOffset = offset + size;
+    return offset;
+}
+
+void FrameResources::_waitForFrame(Frame& frame) {
+    if(frame.fence == nullptr) return;
+
+    auto waitStart = std::chrono::steady_clock::now();
+
+    // flush on the first attempt so the fence is guaranteed to eventually signal
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    const GLuint64 ONE_SECOND = 1000000000;
+    while(true) {
+        GLenum result = glClientWaitSync(frame.fence, flags, ONE_SECOND);
+        if(result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) break;
+        if(result == GL_WAIT_FAILED) {
+            fprintf(stderr, "[ERROR]: Waiting on frame fence failed\n");
+            break;
+        }
+        flags = 0;
+    }
+
+    glDeleteSync(frame.fence);
+    frame.fence = nullptr;
+
+    _totalFenceWaitTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count();
+}
+
+void FrameResources::_readGpuTime(Frame& frame) {
+    if(!frame.queryPending) return;
+
+    GLuint64 elapsed = 0;
+    glGetQueryObjectui64v(frame.timeElapsedQuery, GL_QUERY_RESULT, &elapsed);
+    _lastGpuFrameTime = elapsed;
+    frame.queryPending = GL_FALSE;
+
+    if(_gpuTimeCallback) _gpuTimeCallback(frame.frameNumber, elapsed);
+}
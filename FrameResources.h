@@ -0,0 +1,104 @@
+#ifndef A3_FRAME_RESOURCES_H
+#define A3_FRAME_RESOURCES_H
+
+#include <GL/glew.h>
+
+#include <functional>
+#include <vector>
+
+/// \desc ring of per-frame GPU resources that lets the CPU record up to N frames
+/// ahead of the GPU.  each frame owns a fence, a transient buffer and a timer query
+/// so nothing it touches can still be in use by the GPU when it is reused.
+class FrameResources {
+public:
+    /// \desc the set of resources owned by a single in-flight frame
+    struct Frame {
+        /// \desc signaled once the GPU has finished every command of this frame
+        GLsync fence;
+        /// \desc streaming buffer for data that only lives for this frame
+        GLuint transientBuffer;
+        /// \desc next free byte within the transient buffer
+        GLsizeiptr transientOffset;
+        /// \desc GL_TIME_ELAPSED query wrapped around the whole frame
+        GLuint timeElapsedQuery;
+        /// \desc true if the query has been issued and not yet read back
+        GLboolean queryPending;
+        /// \desc number of the frame that last used this slot
+        GLuint64 frameNumber;
+    };
+
+    /// \desc hook called with a frame's number and its GPU time in nanoseconds once its query is read back
+    using GpuTimeCallback = std::function<void(GLuint64 frameNumber, GLuint64 gpuTime)>;
+
+    /// \desc creates the frame ring, must be called with a current OpenGL context
+    /// \param numFramesInFlight number of frames the CPU may build ahead of the GPU (at least 1)
+    /// \param transientBufferSize size in bytes of each frame's transient buffer
+    FrameResources(GLuint numFramesInFlight, GLsizeiptr transientBufferSize);
+    ~FrameResources();
+
+    FrameResources(const FrameResources&) = delete;
+    FrameResources& operator=(const FrameResources&) = delete;
+
+    /// \desc waits until the GPU has retired the frame that last used the next slot,
+    /// reads back its timer query and resets the slot for recording
+    /// \return resources of the frame now being built
+    Frame& beginFrame();
+
+    /// \desc closes the frame's timer query and fences the submitted commands
+    void endFrame();
+
+    /// \desc waits for every frame still in flight, oldest first, and reads back their timer queries
+    void retireAll();
+
+    /// \desc sets the hook called for every timer query read back, an empty function disables it
+    void setGpuTimeCallback(GpuTimeCallback callback) { _gpuTimeCallback = std::move(callback); }
+
+    /// \desc copies data into the current frame's transient buffer
+    /// \param data bytes to upload
+    /// \param size number of bytes to upload
+    /// \param alignment required alignment of the returned offset
+    /// \return byte offset of the data within the transient buffer, or -1 if the buffer is full
+    /// \note the write is unsynchronized, the fence waited on in beginFrame() guarantees
+    /// the GPU is no longer reading this region
+    GLintptr uploadTransient(const void* data, GLsizeiptr size, GLsizeiptr alignment);
+
+    /// \desc handle of the transient buffer belonging to the frame being built
+    [[nodiscard]] GLuint getTransientBuffer() const { return _frames[_currentFrame].transientBuffer; }
+
+    /// \desc number of frames the CPU may build ahead of the GPU
+    [[nodiscard]] GLuint getNumFramesInFlight() const { return (GLuint)_frames.size(); }
+
+    /// \desc total number of frames begun since creation
+    [[nodiscard]] GLuint64 getFrameNumber() const { return _frameNumber; }
+
+    /// \desc GPU time of the most recently retired frame in nanoseconds
+    [[nodiscard]] GLuint64 getLastGpuFrameTime() const { return _lastGpuFrameTime; }
+
+    /// \desc total time in nanoseconds the CPU has spent blocked on frame fences
+    [[nodiscard]] GLuint64 getTotalFenceWaitTime() const { return _totalFenceWaitTime; }
+
+private:
+    /// \desc per-frame resources, indexed by frame number modulo the number of frames in flight
+    std::vector<Frame> _frames;
+    /// \desc slot of the frame currently being built
+    GLuint _currentFrame;
+    /// \desc size of each transient buffer
+    GLsizeiptr _transientBufferSize;
+    /// \desc running frame counter
+    GLuint64 _frameNumber;
+    /// \desc GPU time of the most recently retired frame
+    GLuint64 _lastGpuFrameTime;
+    /// \desc accumulated fence wait time
+    GLuint64 _totalFenceWaitTime;
+
+    /// \desc hook called for every timer query read back
+    GpuTimeCallback _gpuTimeCallback;
+
+    /// \desc blocks until the fence of a frame is signaled and then deletes it
+    void _waitForFrame(Frame& frame);
+    /// \desc reads back a frame's timer query if it has one pending
+    /// \note the frame's fence must have passed, otherwise this stalls
+    void _readGpuTime(Frame& frame);
+};
+
+#endif //A3_FRAME_RESOURCES_H
@@ -0,0 +1,151 @@
+#include "FrameTelemetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+//*************************************************************************************
+//
+// Histogram
+
+void FrameTimeHistogram::record(const uint64_t nanoseconds) {
+    const uint64_t microseconds = std::min(nanoseconds / 1000, MAX_TRACKABLE);
+    _counts[_bucketIndex(microseconds)]++;
+    _count++;
+    _maxNanoseconds = std::max(_maxNanoseconds, nanoseconds);
+}
+
+void FrameTimeHistogram::add(const FrameTimeHistogram& other) {
+    for(size_t i = 0; i < NUM_BUCKETS; i++) _counts[i] += other._counts[i];
+    _count += other._count;
+    _maxNanoseconds = std::max(_maxNanoseconds, other._maxNanoseconds);
+}
+
+void FrameTimeHistogram::reset() {
+    _counts.fill(0);
+    _count = 0;
+    _maxNanoseconds = 0;
+}
+
+GLdouble FrameTimeHistogram::getValueAtPercentile(const GLdouble percentile) const {
+    if(_count == 0) return 0.0;
+
+    const uint64_t target = std::max((uint64_t)1, (uint64_t)std::ceil(std::min(percentile, 100.0) / 100.0 * (GLdouble)_count));
+    uint64_t seen = 0;
+    for(size_t i = 0; i < NUM_BUCKETS; i++) {
+        seen += _counts[i];
+        if(seen >= target) {
+            // the bucket edge can overshoot the longest time actually recorded
+            return std::min((GLdouble)_bucketUpperEdge(i) / 1000.0, getMax());
+        }
+    }
+    return getMax();
+}
+
+size_t FrameTimeHistogram::_bucketIndex(uint64_t microseconds) {
+    // halve until the value is inside the linear range, the number of halvings picks the power of two
+    size_t shift = 0;
+    while(microseconds >= 2 * SUB_BUCKETS) {
+        microseconds >>= 1;
+        shift++;
+    }
+    return shift * SUB_BUCKETS + (size_t)microseconds;
+}
+
+uint64_t FrameTimeHistogram::_bucketUpperEdge(const size_t index) {
+    const size_t shift = index < 2 * SUB_BUCKETS ? 0 : index / SUB_BUCKETS - 1;
+    const uint64_t subBucket = index - shift * SUB_BUCKETS;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+//*************************************************************************************
+//
+// Telemetry
+
+/// \desc seconds between the render thread handing its histograms over
+static constexpr GLdouble PUBLISH_INTERVAL = 0.25;
+/// \desc names of the metrics in the log and the report
+static const char* const METRIC_NAMES[] = {"cpu", "gpu", "present"};
+
+FrameTelemetry::FrameTelemetry(const GLdouble reportInterval) {
+    _reportInterval = std::chrono::duration<GLdouble>(reportInterval);
+    _nextPublishTime = _lastReportTime = std::chrono::steady_clock::now();
+}
+
+void FrameTelemetry::publish(const bool force) {
+    const auto currentTime = std::chrono::steady_clock::now();
+    if(!force && currentTime < _nextPublishTime) return;
+
+    // never wait on the main thread, it is only ever holding the lock for a copy
+    std::unique_lock<std::mutex> lock(_publishedMutex, std::defer_lock);
+    if(force) {
+        lock.lock();
+    } else if(!lock.try_lock()) {
+        return;
+    }
+
+    for(size_t i = 0; i < NUM_METRICS; i++) {
+        _published[i].add(_recording[i]);
+        _recording[i].reset();
+    }
+    _nextPublishTime = currentTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<GLdouble>(PUBLISH_INTERVAL));
+}
+
+void FrameTelemetry::report(const bool force) {
+    const auto currentTime = std::chrono::steady_clock::now();
+    if(!force && currentTime - _lastReportTime < _reportInterval) return;
+
+    {
+        std::lock_guard<std::mutex> lock(_publishedMutex);
+        _reporting = _published;
+        for(FrameTimeHistogram& histogram : _published) histogram.reset();
+    }
+    const GLdouble intervalSeconds = std::chrono::duration<GLdouble>(currentTime - _lastReportTime).count();
+    _lastReportTime = currentTime;
+
+    if(_reporting[(size_t)Metric::CPU].getCount() == 0) return;
+
+    fprintf(stdout, "[INFO]: Frame times over %.1f s in ms (p50 / p90 / p99 / p99.9 / max):", intervalSeconds);
+    for(size_t i = 0; i < NUM_METRICS; i++) {
+        const FrameTimeHistogram& histogram = _reporting[i];
+        if(histogram.getCount() == 0) continue;
+        fprintf(stdout, " %s %.2f / %.2f / %.2f / %.2f / %.2f%s", METRIC_NAMES[i],
+                histogram.getValueAtPercentile(50.0), histogram.getValueAtPercentile(90.0), histogram.getValueAtPercentile(99.0),
+                histogram.getValueAtPercentile(99.9), histogram.getMax(), i + 1 < NUM_METRICS ? "," : "");
+    }
+    fprintf(stdout, "\n");
+
+    if(!_outputPath.empty()) _writeReport(intervalSeconds);
+}
+
+void FrameTelemetry::_writeReport(const GLdouble intervalSeconds) const {
+    // write beside the endpoint and rename over it so a poller never reads half a report
+    const std::string temporaryPath = _outputPath + ".tmp";
+    FILE* pFile = fopen(temporaryPath.c_str(), "w");
+    if(pFile == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not open telemetry output \"%s\"\n", temporaryPath.c_str());
+        return;
+    }
+
+    fprintf(pFile, "{\n  \"timestamp\": %lld,\n  \"intervalSeconds\": %.3f", (long long)time(nullptr), intervalSeconds);
+    for(size_t i = 0; i < NUM_METRICS; i++) {
+        const FrameTimeHistogram& histogram = _reporting[i];
+        fprintf(pFile, ",\n  \"%s\": {\"count\": %llu, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"p999\": %.4f, \"max\": %.4f}",
+                METRIC_NAMES[i], (unsigned long long)histogram.getCount(),
+                histogram.getValueAtPercentile(50.0), histogram.getValueAtPercentile(90.0), histogram.getValueAtPercentile(99.0),
+                histogram.getValueAtPercentile(99.9), histogram.getMax());
+    }
+    fprintf(pFile, "\n}\n");
+    fclose(pFile);
+
+#ifdef _WIN32
+    // rename does not replace an existing file on Windows, so clear the way first and accept
+    // that a reader may briefly find no report there
+    remove(_outputPath.c_str());
+#endif
+    // elsewhere rename replaces the report in one step, so a reader never finds it missing
+    if(rename(temporaryPath.c_str(), _outputPath.c_str()) != 0) {
+        fprintf(stderr, "[ERROR]: Could not move telemetry report to \"%s\"\n", _outputPath.c_str());
+    }
+}
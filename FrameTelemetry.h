@@ -0,0 +1,126 @@
+#ifndef A3_FRAME_TELEMETRY_H
+#define A3_FRAME_TELEMETRY_H
+
+#include <GL/glew.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+/// \desc fixed memory histogram of durations with log-linear buckets, in the style of HdrHistogram.
+///
+/// durations are kept in microseconds.  below 128 us every microsecond has its own bucket,
+/// above that each power of two is split into 64 buckets, so any recorded value is known to
+/// within 1/64 of itself up to the largest trackable value of about four minutes.
+class FrameTimeHistogram {
+public:
+    /// \desc sub-buckets per power of two above the linear range
+    static constexpr GLuint SUB_BUCKETS = 64;
+    /// \desc number of buckets
+    static constexpr size_t NUM_BUCKETS = 21 * SUB_BUCKETS + 2 * SUB_BUCKETS;
+    /// \desc largest duration in microseconds that can be told apart, longer ones are clamped to it
+    static constexpr uint64_t MAX_TRACKABLE = ((uint64_t)2 * SUB_BUCKETS << 21) - 1;
+
+    FrameTimeHistogram() { reset(); }
+
+    /// \desc adds one duration, never allocates
+    /// \param nanoseconds duration to add
+    void record(uint64_t nanoseconds);
+    /// \desc adds every duration of another histogram
+    void add(const FrameTimeHistogram& other);
+    /// \desc forgets every duration
+    void reset();
+
+    /// \desc number of durations recorded
+    [[nodiscard]] uint64_t getCount() const { return _count; }
+    /// \desc longest duration recorded in milliseconds, exact
+    [[nodiscard]] GLdouble getMax() const { return (GLdouble)_maxNanoseconds / 1000000.0; }
+    /// \desc duration in milliseconds that a percentage of the recorded durations are at or below
+    /// \param percentile percentage between 0 and 100
+    /// \return the upper edge of the bucket the percentile falls in, 0 if nothing is recorded
+    [[nodiscard]] GLdouble getValueAtPercentile(GLdouble percentile) const;
+
+private:
+    /// \desc durations per bucket
+    std::array<uint64_t, NUM_BUCKETS> _counts;
+    /// \desc number of durations recorded
+    uint64_t _count;
+    /// \desc longest duration recorded
+    uint64_t _maxNanoseconds;
+
+    /// \desc bucket a duration in microseconds falls in
+    static size_t _bucketIndex(uint64_t microseconds);
+    /// \desc largest duration in microseconds that falls in a bucket
+    static uint64_t _bucketUpperEdge(size_t index);
+};
+
+/// \desc collects the CPU, GPU and present time of every frame and periodically reports their
+/// percentiles to the log and to a JSON file a monitoring agent can poll.
+///
+/// the render thread records into histograms only it touches and every so often folds them into
+/// a shared set under a lock it never waits on, so recording neither allocates nor blocks.  the
+/// main thread takes the shared set once per report interval and does all the formatting and I/O.
+class FrameTelemetry {
+public:
+    /// \desc what a frame time was spent on
+    enum class Metric {
+        /// \desc render thread time building and submitting the frame
+        CPU = 0,
+        /// \desc GPU time executing the frame
+        GPU = 1,
+        /// \desc time spent handing the frame to the window system
+        PRESENT = 2
+    };
+
+    /// \param reportInterval seconds between reports
+    explicit FrameTelemetry(GLdouble reportInterval = 5.0);
+
+    /// \desc sets the seconds between reports
+    void setReportInterval(GLdouble reportInterval) { _reportInterval = std::chrono::duration<GLdouble>(reportInterval); }
+    /// \desc sets the file each report is written to, empty only logs
+    void setOutputPath(const char* path) { _outputPath = path; }
+
+    /// \desc adds a frame time, called by the render thread only
+    /// \param metric what the time was spent on
+    /// \param nanoseconds time spent
+    void record(Metric metric, uint64_t nanoseconds) { _recording[(size_t)metric].record(nanoseconds); }
+    /// \desc hands what the render thread has recorded over to the main thread if it is time to,
+    /// called by the render thread once a frame
+    /// \param force true to hand over now and wait for the lock, for the last frame
+    void publish(bool force = false);
+
+    /// \desc logs and writes a report if the interval has passed, called by the main thread
+    /// \param force true to report now whatever the interval, for shutdown
+    void report(bool force = false);
+
+private:
+    /// \desc number of metrics
+    static constexpr size_t NUM_METRICS = 3;
+
+    /// \desc seconds between reports
+    std::chrono::duration<GLdouble> _reportInterval;
+    /// \desc file each report is written to, empty only logs
+    std::string _outputPath;
+
+    /// \desc histograms the render thread records into
+    std::array<FrameTimeHistogram, NUM_METRICS> _recording;
+    /// \desc next time the render thread hands its histograms over
+    std::chrono::steady_clock::time_point _nextPublishTime;
+
+    /// \desc guards the shared histograms
+    std::mutex _publishedMutex;
+    /// \desc histograms handed over since the last report
+    std::array<FrameTimeHistogram, NUM_METRICS> _published;
+
+    /// \desc histograms being reported, only touched by the main thread
+    std::array<FrameTimeHistogram, NUM_METRICS> _reporting;
+    /// \desc time of the last report
+    std::chrono::steady_clock::time_point _lastReportTime;
+
+    /// \desc writes the report as JSON next to the output file and moves it into place
+    void _writeReport(GLdouble intervalSeconds) const;
+};
+
+#endif //A3_FRAME_TELEMETRY_H
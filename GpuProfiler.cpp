@@ -0,0 +1,157 @@
+#include "GpuProfiler.h"
+
+#include <cstdio>
+#include <cstring>
+
+/// \desc frames between remapping the GPU clock onto the profiler's, the two clocks drift apart slowly
+static constexpr GLuint CALIBRATION_PERIOD = 300;
+
+GpuProfiler::GpuProfiler(GLuint numFramesLatency) {
+    if(numFramesLatency < 1) numFramesLatency = 1;
+
+    _frames.resize(numFramesLatency);
+    for(Frame& frame : _frames) {
+        frame.numQueriesUsed = 0;
+        frame.isPending = GL_FALSE;
+        frame.profilerFrameNumber = 0;
+    }
+    _currentFrame = 0;
+    _frameNumber = 0;
+    _numDroppedFrames = 0;
+    _pTrack = nullptr;
+    _gpuToProfilerOffset = 0;
+    _framesSinceCalibration = 0;
+
+    _calibrate();
+}
+
+GpuProfiler::~GpuProfiler() {
+    for(Frame& frame : _frames) {
+        if(!frame.queries.empty()) glDeleteQueries((GLsizei)frame.queries.size(), frame.queries.data());
+    }
+}
+
+void GpuProfiler::beginFrame() {
+    _currentFrame = (GLuint)(_frameNumber % _frames.size());
+    Frame& frame = _frames[_currentFrame];
+
+    if(frame.isPending) {
+        // queries finish in the order they were issued, so the last one tells for the whole frame
+        GLint isAvailable = GL_TRUE;
+        if(frame.numQueriesUsed > 0) {
+            glGetQueryObjectiv(frame.queries[frame.numQueriesUsed - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+        }
+        if(isAvailable) {
+            _readFrame(frame);
+        } else {
+            // never wait, the slot is needed now and its results are given up on
+            _numDroppedFrames++;
+        }
+    }
+
+    if(++_framesSinceCalibration >= CALIBRATION_PERIOD) _calibrate();
+
+    frame.numQueriesUsed = 0;
+    frame.scopes.clear();
+    frame.isPending = GL_FALSE;
+    frame.profilerFrameNumber = Profiler::getFrameNumber();
+    _openScopes.clear();
+}
+
+void GpuProfiler::endFrame() {
+    while(!_openScopes.empty()) endScope();
+
+    _frames[_currentFrame].isPending = GL_TRUE;
+    _frameNumber++;
+}
+
+void GpuProfiler::retireAll() {
+    // oldest first, the slot after the current one was recorded longest ago
+    for(size_t i = 1; i <= _frames.size(); i++) {
+        Frame& frame = _frames[(_currentFrame + i) % _frames.size()];
+        if(frame.isPending) _readFrame(frame);
+    }
+}
+
+void GpuProfiler::beginScope(const char* name) {
+    Frame& frame = _frames[_currentFrame];
+    const GLuint beginQuery = _issueTimestamp();
+    frame.scopes.push_back({name, (GLuint)_openScopes.size(), beginQuery, beginQuery});
+    _openScopes.push_back((GLuint)frame.scopes.size() - 1);
+}
+
+void GpuProfiler::endScope() {
+    if(_openScopes.empty()) {
+        fprintf(stderr, "[ERROR]: GPU profiler scope ended without one being open\n");
+        return;
+    }
+    Frame& frame = _frames[_currentFrame];
+    frame.scopes[_openScopes.back()].endQuery = _issueTimestamp();
+    _openScopes.pop_back();
+}
+
+void GpuProfiler::printSummary() const {
+    if(_scopeStats.empty()) return;
+
+    fprintf(stdout, "[INFO]: GPU time per scope:\n");
+    for(const ScopeStats& stats : _scopeStats) {
+        fprintf(stdout, "[INFO]: %*s%-*s %8.3f ms avg over %llu frames\n",
+                (int)(stats.depth * 2), "", (int)(24 - stats.depth * 2), stats.name,
+                stats.totalTime / (GLdouble)stats.count, (unsigned long long)stats.count);
+    }
+    if(_numDroppedFrames > 0) {
+        fprintf(stdout, "[INFO]: %llu frame(s) of GPU timings were not ready in time and were dropped\n",
+                (unsigned long long)_numDroppedFrames);
+    }
+}
+
+GLuint GpuProfiler::_issueTimestamp() {
+    Frame& frame = _frames[_currentFrame];
+    if(frame.numQueriesUsed == frame.queries.size()) {
+        GLuint query;
+        glGenQueries(1, &query);
+        frame.queries.push_back(query);
+    }
+    const GLuint index = frame.numQueriesUsed++;
+    glQueryCounter(frame.queries[index], GL_TIMESTAMP);
+    return index;
+}
+
+void GpuProfiler::_readFrame(Frame& frame) {
+    frame.isPending = GL_FALSE;
+
+    if(Profiler::isEnabled() && _pTrack == nullptr) _pTrack = Profiler::createTrack("GPU");
+
+    for(const Scope& scope : frame.scopes) {
+        GLuint64 beginTime = 0, endTime = 0;
+        glGetQueryObjectui64v(frame.queries[scope.beginQuery], GL_QUERY_RESULT, &beginTime);
+        glGetQueryObjectui64v(frame.queries[scope.endQuery], GL_QUERY_RESULT, &endTime);
+        if(endTime < beginTime) endTime = beginTime;
+
+        ScopeStats* pStats = nullptr;
+        for(ScopeStats& stats : _scopeStats) {
+            if(strcmp(stats.name, scope.name) == 0) { pStats = &stats; break; }
+        }
+        if(pStats == nullptr) {
+            _scopeStats.push_back({scope.name, scope.depth, 0.0, 0});
+            pStats = &_scopeStats.back();
+        }
+        pStats->totalTime += (GLdouble)(endTime - beginTime) / 1000000.0;
+        pStats->count++;
+
+        if(_pTrack != nullptr && Profiler::isEnabled()) {
+            Profiler::record(_pTrack, scope.name,
+                             (int64_t)beginTime + _gpuToProfilerOffset, (int64_t)endTime + _gpuToProfilerOffset,
+                             frame.profilerFrameNumber);
+        }
+    }
+}
+
+void GpuProfiler::_calibrate() {
+    // GL_TIMESTAMP read directly is the GPU time once the commands issued so far have reached
+    // the GPU, close enough to the CPU time read next to it to line the two timelines up
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    _gpuToProfilerOffset = Profiler::now() - gpuTime;
+    _framesSinceCalibration = 0;
+}
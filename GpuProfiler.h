@@ -0,0 +1,142 @@
+#ifndef A3_GPU_PROFILER_H
+#define A3_GPU_PROFILER_H
+
+#include <GL/glew.h>
+
+#include "Profiler.h"
+
+#include <vector>
+
+/// \desc measures how long named, nestable scopes of GL commands take on the GPU.
+///
+/// each scope is bracketed by a pair of GL_TIMESTAMP queries, which unlike GL_TIME_ELAPSED
+/// may nest and overlap the frame's own timer query.  queries come from a per-frame pool and
+/// are only read back when their slot comes around again, a few frames later, and only if
+/// the GPU reports them available, so reading results never stalls the render thread.
+///
+/// GPU timestamps are mapped onto the CPU profiler's clock, so while the CPU profiler is
+/// enabled every scope is also recorded on a "GPU" track of the same timeline.
+class GpuProfiler {
+public:
+    /// \desc average GPU time of every scope with one name
+    struct ScopeStats {
+        /// \desc name of the scope
+        const char* name;
+        /// \desc nesting depth the scope was first seen at, 0 for the outermost
+        GLuint depth;
+        /// \desc summed GPU time in milliseconds
+        GLdouble totalTime;
+        /// \desc number of times the scope was read back
+        GLuint64 count;
+    };
+
+    /// \desc creates the query pools, must be called with a current OpenGL context
+    /// \param numFramesLatency number of frames results are read back after, should be more than the frames in flight
+    explicit GpuProfiler(GLuint numFramesLatency);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    /// \desc reads back the frame that last used the next slot if the GPU has finished it and starts recording a new frame
+    void beginFrame();
+    /// \desc closes any scopes left open in the frame
+    void endFrame();
+    /// \desc blocks until every frame still in flight can be read back and reads them, for shutdown
+    void retireAll();
+
+    /// \desc starts a scope nested inside any scope still open
+    /// \param name name of the scope, must be a string that lives for the whole run
+    void beginScope(const char* name);
+    /// \desc ends the innermost open scope
+    void endScope();
+
+    /// \desc GPU time of every scope read back so far, in the order they were first seen
+    [[nodiscard]] const std::vector<ScopeStats>& getScopeStats() const { return _scopeStats; }
+    /// \desc prints the average GPU time of every scope
+    void printSummary() const;
+
+private:
+    /// \desc a scope recorded in a frame
+    struct Scope {
+        /// \desc name of the scope
+        const char* name;
+        /// \desc nesting depth, 0 for the outermost
+        GLuint depth;
+        /// \desc index of the query at its start within the frame's pool
+        GLuint beginQuery;
+        /// \desc index of the query at its end within the frame's pool
+        GLuint endQuery;
+    };
+    /// \desc queries and scopes of one frame slot
+    struct Frame {
+        /// \desc timestamp queries, grown as a frame needs more and kept from then on
+        std::vector<GLuint> queries;
+        /// \desc number of queries issued this frame
+        GLuint numQueriesUsed;
+        /// \desc scopes recorded this frame in the order they began
+        std::vector<Scope> scopes;
+        /// \desc true if the frame has been recorded and not yet read back
+        GLboolean isPending;
+        /// \desc profiler frame the scopes are tagged with
+        uint64_t profilerFrameNumber;
+    };
+
+    /// \desc per-frame pools, indexed by frame number modulo the latency
+    std::vector<Frame> _frames;
+    /// \desc slot of the frame being recorded
+    GLuint _currentFrame;
+    /// \desc running frame counter
+    GLuint64 _frameNumber;
+    /// \desc indices of the scopes still open in the current frame, innermost last
+    std::vector<GLuint> _openScopes;
+    /// \desc GPU time of every scope read back so far
+    std::vector<ScopeStats> _scopeStats;
+    /// \desc number of frames whose results were not ready when their slot was reused
+    GLuint64 _numDroppedFrames;
+
+    /// \desc track GPU scopes are recorded on in the CPU profiler, created on first use
+    Profiler::Track* _pTrack;
+    /// \desc profiler time minus GPU time, in nanoseconds
+    int64_t _gpuToProfilerOffset;
+    /// \desc frames since the GPU clock was last mapped onto the profiler's
+    GLuint _framesSinceCalibration;
+
+    /// \desc issues a timestamp query from the current frame's pool
+    /// \return index of the query within the pool
+    GLuint _issueTimestamp();
+    /// \desc reads the results of a frame and adds them to the stats and the CPU profiler
+    /// \note every query of the frame must be available, otherwise this stalls
+    void _readFrame(Frame& frame);
+    /// \desc maps the GPU clock onto the profiler's clock
+    void _calibrate();
+};
+
+/// \desc times the GL commands issued from its construction to its destruction as a GPU scope
+class GpuProfileScope {
+public:
+    /// \param pGpuProfiler profiler to record with, nothing is recorded if null
+    /// \param name name of the scope, must be a string that lives for the whole run
+    GpuProfileScope(GpuProfiler* pGpuProfiler, const char* name) : _pGpuProfiler(pGpuProfiler) {
+        if(_pGpuProfiler != nullptr) _pGpuProfiler->beginScope(name);
+    }
+    ~GpuProfileScope() {
+        if(_pGpuProfiler != nullptr) _pGpuProfiler->endScope();
+    }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    /// \desc profiler the scope is recorded with
+    GpuProfiler* _pGpuProfiler;
+};
+
+#ifdef A3_ENABLE_PROFILER
+/// \desc times the GL commands issued in the rest of the enclosing scope under a name
+#define A3_GPU_PROFILE_SCOPE(pGpuProfiler, name) GpuProfileScope A3_PROFILE_CONCAT(gpuProfileScope, __LINE__)(pGpuProfiler, name)
+#else
+#define A3_GPU_PROFILE_SCOPE(pGpuProfiler, name) ((void)0)
+#endif
+
+#endif //A3_GPU_PROFILER_H
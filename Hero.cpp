@@ -1,15 +1,14 @@
 #include "Hero.h"
+#include "Profiler.h"
+#include "RenderStats.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <CSCI441/objects.hpp>
 #include <CSCI441/OpenGLUtils.hpp>
 
-Hero::Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation ) {
-    _shaderProgramHandle                            = shaderProgramHandle;
-    _shaderProgramUniformLocations.mvpMtx           = mvpMtxUniformLocation;
-    _shaderProgramUniformLocations.normalMtx        = normalMtxUniformLocation;
-    _shaderProgramUniformLocations.materialColor    = materialColorUniformLocation;
+Hero::Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint modelMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation ) {
+    setShaderProgram(shaderProgramHandle, mvpMtxUniformLocation, modelMtxUniformLocation, normalMtxUniformLocation, materialColorUniformLocation);
 
     // Initializes all of our matrix calculations to draw our hero's body.
     _transWholeBody = glm::vec3( 0.0f, 2.2f, 0.0f);
@@ -41,10 +40,20 @@ Hero::Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normal
     _scaleArm = glm::vec3(0.5f, 1.0f, 1.0f );
 }
 
+void Hero::setShaderProgram(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint modelMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation ) {
+    _shaderProgramHandle                            = shaderProgramHandle;
+    _shaderProgramUniformLocations.mvpMtx           = mvpMtxUniformLocation;
+    _shaderProgramUniformLocations.modelMtx         = modelMtxUniformLocation;
+    _shaderProgramUniformLocations.normalMtx        = normalMtxUniformLocation;
+    _shaderProgramUniformLocations.materialColor    = materialColorUniformLocation;
+}
+
 // Main function to put together the hero and draw it as a whole.
-void Hero::drawHero(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) {
+void Hero::drawHero(glm::mat4 modelMtx, GLfloat bodyAngle, glm::mat4 viewMtx, glm::mat4 projMtx ) const {
+    A3_PROFILE_FUNCTION();
+
     glm::mat4 modelMtx1 = glm::translate( modelMtx, _transWholeBody );
-    modelMtx1 = glm::rotate( modelMtx1, _bodyAngle, CSCI441::Y_AXIS );
+    modelMtx1 = glm::rotate( modelMtx1, bodyAngle, CSCI441::Y_AXIS );
     modelMtx1 = glm::scale( modelMtx1, _scaleWholeBody );
     _drawHeroBody(modelMtx1, viewMtx, projMtx);
     _drawHeroArm(modelMtx1, viewMtx, projMtx);
@@ -71,8 +80,9 @@ void Hero::_drawHeroHead(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMt
     _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
 
     glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorHead[0]);
+    RenderStats::countUniformUpload(sizeof(_colorHead));
 
-    CSCI441::drawSolidSphere( 0.8f, 10, 10);
+    countedDrawSolidSphere( 0.8f, 10, 10);
 }
 
 // Creates the function to correctly scale and draw our hero eyes left and right using spheres.
@@ -83,8 +93,9 @@ void Hero::_drawHeroLeftEye(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 pro
     _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
 
     glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorLeftEye[0]);
+    RenderStats::countUniformUpload(sizeof(_colorLeftEye));
 
-    CSCI441::drawSolidSphere( 0.2f, 10, 10);
+    countedDrawSolidSphere( 0.2f, 10, 10);
 }
 
 void Hero::_drawHeroRightEye(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx ) const {
@@ -94,8 +105,9 @@ void Hero::_drawHeroRightEye(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 pr
     _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
 
     glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorRightEye[0]);
+    RenderStats::countUniformUpload(sizeof(_colorRightEye));
 
-    CSCI441::drawSolidSphere( 0.2f, 10, 10);
+    countedDrawSolidSphere( 0.2f, 10, 10);
 }
 
 // Creates the function to correctly scale and draw our hero's body using a cube.
@@ -106,8 +118,9 @@ void Hero::_drawHeroBody(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMt
     _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
 
     glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorBody[0]);
+    RenderStats::countUniformUpload(sizeof(_colorBody));
 
-    CSCI441::drawSolidCube( 0.1f );
+    countedDrawSolidCube( 0.1f );
 }
 
 // Creates the function to correctly scale and draw our hero's legs using a cube.
@@ -118,8 +131,9 @@ void Hero::_drawHeroLegs(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMt
     _computeAndSendMatrixUniforms(modelMtx1, viewMtx, projMtx);
 
     glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorLegs[0]);
+    RenderStats::countUniformUpload(sizeof(_colorLegs));
 
-    CSCI441::drawSolidCube( 0.1f );
+    countedDrawSolidCube( 0.1f );
 }
 
 // Creates the function to correctly scale and draw our hero's arms using a cube.
@@ -129,8 +143,9 @@ void Hero::_drawHeroArm(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx
     _computeAndSendMatrixUniforms(modelMtx, viewMtx, projMtx);
 
     glProgramUniform3fv(_shaderProgramHandle, _shaderProgramUniformLocations.materialColor, 1, &_colorArm[0]);
+    RenderStats::countUniformUpload(sizeof(_colorArm));
 
-    CSCI441::drawSolidCube( 0.17f );
+    countedDrawSolidCube( 0.17f );
 }
 
 void Hero::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx) const {
@@ -138,7 +153,14 @@ void Hero::_computeAndSendMatrixUniforms(glm::mat4 modelMtx, glm::mat4 viewMtx,
     glm::mat4 mvpMtx = projMtx * viewMtx * modelMtx;
     // then send it to the shader on the GPU to apply to every vertex
     glProgramUniformMatrix4fv( _shaderProgramHandle, _shaderProgramUniformLocations.mvpMtx, 1, GL_FALSE, &mvpMtx[0][0] );
+    RenderStats::countUniformUpload(sizeof(mvpMtx));
+    // the model matrix is only read by shader variants with point lights
+    if( _shaderProgramUniformLocations.modelMtx != -1 ) {
+        glProgramUniformMatrix4fv( _shaderProgramHandle, _shaderProgramUniformLocations.modelMtx, 1, GL_FALSE, &modelMtx[0][0] );
+        RenderStats::countUniformUpload(sizeof(modelMtx));
+    }
 
     glm::mat3 normalMtx = glm::mat3( glm::transpose( glm::inverse( modelMtx )));
     glProgramUniformMatrix3fv( _shaderProgramHandle, _shaderProgramUniformLocations.normalMtx, 1, GL_FALSE, &normalMtx[0][0] );
+    RenderStats::countUniformUpload(sizeof(normalMtx));
 }
@@ -11,17 +11,28 @@ public:
     /// \desc creates a simple hero
     /// \param shaderProgramHandle shader program handle that the hero should be drawn using
     /// \param mvpMtxUniformLocation uniform location for the full precomputed MVP matrix
+    /// \param modelMtxUniformLocation uniform location for the model matrix
     /// \param normalMtxUniformLocation uniform location for the precomputed Normal matrix
     /// \param materialColorUniformLocation uniform location for the material diffuse color
-    Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation );
+    Hero(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint modelMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation );
+
+    /// \desc points the hero at another shader program, such as one recompiled after its source changed
+    /// \param shaderProgramHandle shader program handle that the hero should be drawn using
+    /// \param mvpMtxUniformLocation uniform location for the full precomputed MVP matrix
+    /// \param modelMtxUniformLocation uniform location for the model matrix
+    /// \param normalMtxUniformLocation uniform location for the precomputed Normal matrix
+    /// \param materialColorUniformLocation uniform location for the material diffuse color
+    void setShaderProgram(GLuint shaderProgramHandle, GLint mvpMtxUniformLocation, GLint modelMtxUniformLocation, GLint normalMtxUniformLocation, GLint materialColorUniformLocation );
 
     /// \desc draws the model hero for a given MVP matrix
     /// \param modelMtx existing model matrix to apply to hero
+    /// \param bodyAngle heading of the hero to draw, as returned by getBodyAngle()
     /// \param viewMtx camera view matrix to apply to hero
     /// \param projMtx camera projection matrix to apply to hero
     /// \note internally uses the provided shader program and sets the necessary uniforms
     /// for the MVP and Normal Matrices as well as the material diffuse color
-    void drawHero( glm::mat4 modelMtx, glm::mat4 viewMtx, glm::mat4 projMtx );
+    /// \note the heading is passed in so the hero can be drawn from a snapshot while it keeps turning
+    void drawHero( glm::mat4 modelMtx, GLfloat bodyAngle, glm::mat4 viewMtx, glm::mat4 projMtx ) const;
 
     // Creates function to get our angle for use of moving forward and backward with heading.
     GLfloat getBodyAngle() const { return _bodyAngle; }
@@ -37,6 +48,8 @@ private:
     struct ShaderProgramUniformLocations {
         /// \desc location of the precomputed ModelViewProjection matrix
         GLint mvpMtx;
+        /// \desc location of the Model matrix
+        GLint modelMtx;
         /// \desc location of the precomputed Normal matrix
         GLint normalMtx;
         /// \desc location of the material diffuse color
@@ -0,0 +1,229 @@
+#include "InputRecording.h"
+
+#include <cmath>
+#include <cstring>
+
+/// \desc identifies a recording file
+static const char INPUT_RECORDING_MAGIC[4] = {'A', '3', 'I', 'R'};
+/// \desc version of the file layout
+static const uint8_t INPUT_RECORDING_VERSION = 1;
+/// \desc type byte of the record that ends a session
+static const uint8_t END_OF_RECORDING = 0xFF;
+
+//*************************************************************************************
+//
+// Little endian encoding, so recordings can be moved between machines
+
+static void writeBytes(FILE* pFile, uint64_t value, int numBytes) {
+    for(int i = 0; i < numBytes; i++) fputc((int)((value >> (8 * i)) & 0xFF), pFile);
+}
+
+static bool readBytes(FILE* pFile, uint64_t& value, int numBytes) {
+    value = 0;
+    for(int i = 0; i < numBytes; i++) {
+        const int byte = fgetc(pFile);
+        if(byte == EOF) return false;
+        value |= (uint64_t)byte << (8 * i);
+    }
+    return true;
+}
+
+static void writeVarint(FILE* pFile, uint64_t value) {
+    // 7 bits at a time, the high bit marks that more bytes follow
+    while(value >= 0x80) {
+        fputc((int)((value & 0x7F) | 0x80), pFile);
+        value >>= 7;
+    }
+    fputc((int)value, pFile);
+}
+
+static bool readVarint(FILE* pFile, uint64_t& value) {
+    value = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        const int byte = fgetc(pFile);
+        if(byte == EOF) return false;
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+static void writeFloat(FILE* pFile, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    writeBytes(pFile, bits, 4);
+}
+
+static bool readFloat(FILE* pFile, float& value) {
+    uint64_t bits;
+    if(!readBytes(pFile, bits, 4)) return false;
+    const uint32_t bits32 = (uint32_t)bits;
+    memcpy(&value, &bits32, sizeof(value));
+    return true;
+}
+
+//*************************************************************************************
+//
+// Recording
+
+InputRecorder::InputRecorder() {
+    _pFile = nullptr;
+    _lastTick = 0;
+    _numEvents = 0;
+}
+
+InputRecorder::~InputRecorder() {
+    if(_pFile != nullptr) close(_lastTick);
+}
+
+bool InputRecorder::open(const char* path, const GLuint worldSeed, const GLdouble simulationRate) {
+    _pFile = fopen(path, "wb");
+    if(_pFile == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not create input recording \"%s\"\n", path);
+        return false;
+    }
+    _lastTick = 0;
+    _numEvents = 0;
+
+    fwrite(INPUT_RECORDING_MAGIC, 1, sizeof(INPUT_RECORDING_MAGIC), _pFile);
+    writeBytes(_pFile, INPUT_RECORDING_VERSION, 1);
+    writeBytes(_pFile, worldSeed, 4);
+    uint64_t rateBits;
+    memcpy(&rateBits, &simulationRate, sizeof(rateBits));
+    writeBytes(_pFile, rateBits, 8);
+
+    fprintf(stdout, "[INFO]: Recording input to \"%s\" with world seed %u\n", path, worldSeed);
+    return true;
+}
+
+void InputRecorder::record(const InputEvent& event) {
+    if(_pFile == nullptr) return;
+
+    _writeTick(event.tick);
+    writeBytes(_pFile, (uint8_t)event.type, 1);
+    switch(event.type) {
+        case InputEvent::Type::KEY:
+            writeBytes(_pFile, (uint16_t)(int16_t)event.code, 2);
+            writeBytes(_pFile, (uint8_t)event.action, 1);
+            break;
+        case InputEvent::Type::MOUSE_BUTTON:
+            writeBytes(_pFile, (uint8_t)event.code, 1);
+            writeBytes(_pFile, (uint8_t)event.action, 1);
+            break;
+        case InputEvent::Type::CURSOR_POSITION:
+            writeFloat(_pFile, event.position.x);
+            writeFloat(_pFile, event.position.y);
+            break;
+    }
+    _numEvents++;
+}
+
+void InputRecorder::close(const GLuint64 endTick) {
+    if(_pFile == nullptr) return;
+
+    _writeTick(endTick);
+    writeBytes(_pFile, END_OF_RECORDING, 1);
+    fclose(_pFile);
+    _pFile = nullptr;
+
+    fprintf(stdout, "[INFO]: Recorded %zu input events over %llu ticks\n", _numEvents, (unsigned long long)endTick);
+}
+
+void InputRecorder::_writeTick(GLuint64 tick) {
+    if(tick < _lastTick) tick = _lastTick;
+    writeVarint(_pFile, tick - _lastTick);
+    _lastTick = tick;
+}
+
+//*************************************************************************************
+//
+// Replay
+
+InputReplayer::InputReplayer() {
+    _nextEvent = 0;
+    _worldSeed = 0;
+    _simulationRate = 0.0;
+    _endTick = 0;
+    _isLoaded = false;
+}
+
+bool InputReplayer::load(const char* path) {
+    _events.clear();
+    _nextEvent = 0;
+    _isLoaded = false;
+
+    FILE* pFile = fopen(path, "rb");
+    if(pFile == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not open input recording \"%s\"\n", path);
+        return false;
+    }
+
+    char magic[sizeof(INPUT_RECORDING_MAGIC)];
+    uint64_t version, worldSeed, rateBits;
+    if(fread(magic, 1, sizeof(magic), pFile) != sizeof(magic) || memcmp(magic, INPUT_RECORDING_MAGIC, sizeof(magic)) != 0
+       || !readBytes(pFile, version, 1) || version != INPUT_RECORDING_VERSION
+       || !readBytes(pFile, worldSeed, 4) || !readBytes(pFile, rateBits, 8)) {
+        fprintf(stderr, "[ERROR]: \"%s\" is not a version %u input recording\n", path, INPUT_RECORDING_VERSION);
+        fclose(pFile);
+        return false;
+    }
+    _worldSeed = (GLuint)worldSeed;
+    memcpy(&_simulationRate, &rateBits, sizeof(_simulationRate));
+    if(!std::isfinite(_simulationRate) || _simulationRate <= 0.0) {
+        fprintf(stderr, "[ERROR]: Input recording \"%s\" has an invalid simulation rate %g\n", path, _simulationRate);
+        _simulationRate = 0.0;
+        fclose(pFile);
+        return false;
+    }
+
+    GLuint64 tick = 0;
+    bool isComplete = false;
+    while(true) {
+        uint64_t tickDelta, type, code, action;
+        if(!readVarint(pFile, tickDelta) || !readBytes(pFile, type, 1)) break;
+        tick += tickDelta;
+
+        if(type == END_OF_RECORDING) {
+            _endTick = tick;
+            isComplete = true;
+            break;
+        }
+
+        InputEvent event = {tick, (InputEvent::Type)type, 0, 0, glm::vec2(0.0f)};
+        bool isValid = false;
+        switch(event.type) {
+            case InputEvent::Type::KEY:
+                isValid = readBytes(pFile, code, 2) && readBytes(pFile, action, 1);
+                event.code = (GLint)(int16_t)(uint16_t)code;
+                event.action = (GLint)action;
+                break;
+            case InputEvent::Type::MOUSE_BUTTON:
+                isValid = readBytes(pFile, code, 1) && readBytes(pFile, action, 1);
+                event.code = (GLint)code;
+                event.action = (GLint)action;
+                break;
+            case InputEvent::Type::CURSOR_POSITION:
+                isValid = readFloat(pFile, event.position.x) && readFloat(pFile, event.position.y);
+                break;
+        }
+        if(!isValid) break;
+        _events.push_back(event);
+    }
+    fclose(pFile);
+
+    if(!isComplete) {
+        fprintf(stderr, "[ERROR]: Input recording \"%s\" is truncated or corrupt after %zu events\n", path, _events.size());
+        _events.clear();
+        return false;
+    }
+
+    fprintf(stdout, "[INFO]: Replaying %zu input events over %llu ticks with world seed %u\n",
+            _events.size(), (unsigned long long)_endTick, _worldSeed);
+    _isLoaded = true;
+    return true;
+}
+
+const InputEvent* InputReplayer::nextEvent(const GLuint64 tick) {
+    if(_nextEvent >= _events.size() || _events[_nextEvent].tick > tick) return nullptr;
+    return &_events[_nextEvent++];
+}
@@ -0,0 +1,119 @@
+#ifndef A3_INPUT_RECORDING_H
+#define A3_INPUT_RECORDING_H
+
+#include <GL/glew.h>
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/// \desc a recorded input event, stamped with the simulation tick it took effect before
+struct InputEvent {
+    /// \desc kinds of events that can be recorded
+    enum class Type : uint8_t {
+        KEY = 0,
+        MOUSE_BUTTON = 1,
+        CURSOR_POSITION = 2
+    };
+
+    /// \desc simulation tick the event was handled before
+    GLuint64 tick;
+    /// \desc kind of event
+    Type type;
+    /// \desc GLFW key or mouse button, unused for cursor events
+    GLint code;
+    /// \desc GLFW action, unused for cursor events
+    GLint action;
+    /// \desc cursor position in window coordinates, only used for cursor events
+    glm::vec2 position;
+};
+
+/// \desc writes input events to a compact binary file as they are handled.
+///
+/// the file starts with a header holding the world seed and simulation rate the
+/// session ran with, followed by one record per event: the number of ticks since
+/// the previous event as a variable length integer, the event type and its payload.
+/// an end record carries the tick the session stopped at.
+class InputRecorder {
+public:
+    InputRecorder();
+    /// \desc stops the recording at the last tick an event was recorded at if still open
+    ~InputRecorder();
+
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+
+    /// \desc creates the file and writes its header
+    /// \param path file to write
+    /// \param worldSeed seed the world was generated from
+    /// \param simulationRate fixed simulation steps per second
+    /// \return true if the file could be created
+    bool open(const char* path, GLuint worldSeed, GLdouble simulationRate);
+
+    /// \desc appends an event, events must be recorded in tick order
+    void record(const InputEvent& event);
+
+    /// \desc writes the end record and closes the file
+    /// \param endTick simulation tick the session ended at
+    void close(GLuint64 endTick);
+
+    /// \desc true while a file is open
+    [[nodiscard]] bool isRecording() const { return _pFile != nullptr; }
+
+private:
+    /// \desc file being written, buffered by stdio
+    FILE* _pFile;
+    /// \desc tick of the last record, ticks are stored relative to it
+    GLuint64 _lastTick;
+    /// \desc number of events written
+    size_t _numEvents;
+
+    /// \desc writes the tick delta of a record and moves the last tick up to it
+    void _writeTick(GLuint64 tick);
+};
+
+/// \desc reads a file written by InputRecorder and hands its events back tick by tick
+class InputReplayer {
+public:
+    InputReplayer();
+
+    /// \desc reads a whole recording into memory
+    /// \param path file to read
+    /// \return true if the file is a complete recording
+    bool load(const char* path);
+
+    /// \desc true if a recording has been loaded
+    [[nodiscard]] bool isLoaded() const { return _isLoaded; }
+    /// \desc seed the recorded world was generated from
+    [[nodiscard]] GLuint getWorldSeed() const { return _worldSeed; }
+    /// \desc simulation rate the session was recorded at
+    [[nodiscard]] GLdouble getSimulationRate() const { return _simulationRate; }
+    /// \desc tick the recorded session ended at
+    [[nodiscard]] GLuint64 getEndTick() const { return _endTick; }
+
+    /// \desc returns the next event due at or before a tick and moves past it
+    /// \param tick current simulation tick
+    /// \return the event, or nullptr once every event due has been returned
+    const InputEvent* nextEvent(GLuint64 tick);
+
+    /// \desc true once the replay has reached the end of the recorded session
+    [[nodiscard]] bool isFinished(GLuint64 tick) const { return _nextEvent >= _events.size() && tick >= _endTick; }
+
+private:
+    /// \desc every recorded event in tick order
+    std::vector<InputEvent> _events;
+    /// \desc index of the next event to hand out
+    size_t _nextEvent;
+    /// \desc seed the recorded world was generated from
+    GLuint _worldSeed;
+    /// \desc simulation rate the session was recorded at
+    GLdouble _simulationRate;
+    /// \desc tick the recorded session ended at
+    GLuint64 _endTick;
+    /// \desc true if a recording has been loaded
+    bool _isLoaded;
+};
+
+#endif //A3_INPUT_RECORDING_H
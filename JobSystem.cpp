@@ -0,0 +1,202 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cstdio>
+
+/// \desc index of the worker running on this thread, -1 for threads outside the job system
+static thread_local int tWorkerIndex = -1;
+/// \desc job system the worker running on this thread belongs to
+static thread_local const JobSystem* tpWorkerOwner = nullptr;
+
+JobSystem::JobSystem(unsigned int numWorkers)
+        : _isRunning(true),
+          _numQueuedJobs(0),
+          _nextExternalQueue(0),
+          _timingCallback(nullptr) {
+    if(numWorkers == 0) {
+        // leave a core each for the main and render threads
+        unsigned int numCores = std::thread::hardware_concurrency();
+        numWorkers = numCores > 3 ? numCores - 2 : 1;
+    }
+
+    for(unsigned int i = 0; i < numWorkers; i++) {
+        _queues.emplace_back(new WorkerQueue());
+    }
+    for(unsigned int i = 0; i < numWorkers; i++) {
+        _workers.emplace_back(&JobSystem::_workerLoop, this, (int)i);
+    }
+
+    fprintf(stdout, "[INFO]: Job system started with %u worker(s)\n", numWorkers);
+}
+
+JobSystem::~JobSystem() {
+    // let the workers drain whatever is still queued before stopping
+    while(_numQueuedJobs.load(std::memory_order_acquire) > 0) {
+        Job job;
+        if(_tryGetJob(job)) _execute(job);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _isRunning.store(false, std::memory_order_release);
+    }
+    _sleepCondition.notify_all();
+
+    for(std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(const char* name, JobFunction function, Counter* pCounter) {
+    if(pCounter != nullptr) pCounter->_pending.fetch_add(1, std::memory_order_relaxed);
+    _push(Job{std::move(function), name, pCounter});
+}
+
+void JobSystem::submitAfter(Counter& dependency, const char* name, JobFunction function, Counter* pCounter) {
+    if(pCounter != nullptr) pCounter->_pending.fetch_add(1, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(dependency._mutex);
+        if(!dependency.isDone()) {
+            // queued by _retire() once the dependency reaches zero
+            dependency._continuations.emplace_back([this, name, function = std::move(function), pCounter]() mutable {
+                _push(Job{std::move(function), name, pCounter});
+            });
+            return;
+        }
+    }
+
+    _push(Job{std::move(function), name, pCounter});
+}
+
+void JobSystem::parallelFor(const char* name, const size_t count, size_t grainSize, const RangeFunction& function, Counter* pCounter) {
+    if(grainSize < 1) grainSize = 1;
+
+    // every chunk shares one copy of the function so the caller's may go out of scope
+    auto pFunction = std::make_shared<RangeFunction>(function);
+    for(size_t begin = 0; begin < count; begin += grainSize) {
+        const size_t end = std::min(begin + grainSize, count);
+        submit(name, [pFunction, begin, end]() { (*pFunction)(begin, end); }, pCounter);
+    }
+}
+
+void JobSystem::parallelForAndWait(const char* name, const size_t count, const size_t grainSize, const RangeFunction& function) {
+    Counter counter;
+    parallelFor(name, count, grainSize, function, &counter);
+    wait(counter);
+}
+
+void JobSystem::wait(Counter& counter) {
+    // help out instead of blocking so waiting on a worker can never deadlock
+    while(!counter.isDone()) {
+        Job job;
+        if(_tryGetJob(job)) {
+            _execute(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::_workerLoop(const int workerIndex) {
+    tWorkerIndex = workerIndex;
+    tpWorkerOwner = this;
+
+    while(true) {
+        Job job;
+        if(_tryGetJob(job)) {
+            _execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this] {
+            return !_isRunning.load(std::memory_order_acquire) || _numQueuedJobs.load(std::memory_order_acquire) > 0;
+        });
+        if(!_isRunning.load(std::memory_order_acquire)) break;
+    }
+}
+
+void JobSystem::_push(Job job) {
+    unsigned int queueIndex;
+    if(tpWorkerOwner == this) {
+        queueIndex = (unsigned int)tWorkerIndex;
+    } else {
+        queueIndex = _nextExternalQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queues[queueIndex]->mutex);
+        _queues[queueIndex]->jobs.push_back(std::move(job));
+    }
+    _numQueuedJobs.fetch_add(1, std::memory_order_release);
+
+    // take the sleep lock so a worker between its check and its wait cannot miss the signal
+    { std::lock_guard<std::mutex> lock(_sleepMutex); }
+    _sleepCondition.notify_one();
+}
+
+bool JobSystem::_tryGetJob(Job& job) {
+    const size_t numQueues = _queues.size();
+    const bool isOwnWorker = (tpWorkerOwner == this);
+
+    // newest job from our own queue first, it is the most likely to still be in cache
+    if(isOwnWorker) {
+        WorkerQueue& queue = *_queues[tWorkerIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            _numQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    // then steal the oldest job from everyone else
+    const size_t start = isOwnWorker ? (size_t)tWorkerIndex + 1 : 0;
+    for(size_t i = 0; i < numQueues; i++) {
+        const size_t victim = (start + i) % numQueues;
+        if(isOwnWorker && victim == (size_t)tWorkerIndex) continue;
+
+        WorkerQueue& queue = *_queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if(!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            _numQueuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::_execute(Job& job) {
+    TimingCallback timingCallback = _timingCallback.load(std::memory_order_acquire);
+    if(timingCallback != nullptr) {
+        auto start = std::chrono::steady_clock::now();
+        job.function();
+        timingCallback(job.name, tpWorkerOwner == this ? tWorkerIndex : -1, start, std::chrono::steady_clock::now());
+    } else {
+        job.function();
+    }
+
+    _retire(job.pCounter);
+}
+
+void JobSystem::_retire(Counter* pCounter) {
+    if(pCounter == nullptr) return;
+
+    // decrement under the lock so submitAfter() sees either the continuation list or zero,
+    // and so the counter cannot be destroyed before we are done with it
+    std::vector<std::function<void()>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(pCounter->_mutex);
+        if(pCounter->_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuations.swap(pCounter->_continuations);
+        }
+    }
+    for(auto& continuation : continuations) {
+        continuation();
+    }
+}
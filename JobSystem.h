@@ -0,0 +1,142 @@
+#ifndef A3_JOB_SYSTEM_H
+#define A3_JOB_SYSTEM_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// \desc work-stealing job system.  every worker owns a deque it pushes to and pops from
+/// at the back, idle workers steal from the front of the other deques.  jobs are tracked
+/// with counters that can be waited on or used as dependencies for further jobs.
+class JobSystem {
+public:
+    /// \desc function executed by a job
+    using JobFunction = std::function<void()>;
+    /// \desc function executed by each chunk of a parallel for, given the range [begin, end)
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+    /// \desc hook called after every job with its name, the worker that ran it (-1 for a
+    /// thread that is not a worker) and its start and end times
+    using TimingCallback = void(*)(const char* name, int workerIndex,
+                                   std::chrono::steady_clock::time_point start,
+                                   std::chrono::steady_clock::time_point end);
+
+    /// \desc tracks a group of submitted jobs, reaches zero once all of them have finished
+    class Counter {
+    public:
+        Counter() : _pending(0) {}
+        /// \desc waits for a job that is still releasing the counter's continuations
+        ~Counter() { std::lock_guard<std::mutex> lock(_mutex); }
+        Counter(const Counter&) = delete;
+        Counter& operator=(const Counter&) = delete;
+
+        /// \desc true once every job tracked by this counter has finished
+        [[nodiscard]] bool isDone() const { return _pending.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        /// \desc number of tracked jobs that have not finished
+        std::atomic<int> _pending;
+        /// \desc guards the continuation list
+        std::mutex _mutex;
+        /// \desc jobs to submit once the counter reaches zero
+        std::vector<std::function<void()>> _continuations;
+    };
+
+    /// \desc starts the worker threads
+    /// \param numWorkers number of workers, 0 picks one per core not used by the main and render threads
+    explicit JobSystem(unsigned int numWorkers = 0);
+    /// \desc finishes the queued jobs and joins the worker threads
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// \desc queues a job
+    /// \param name label passed to the timing callback, must outlive the job
+    /// \param function work to run
+    /// \param pCounter optional counter to increment now and decrement once the job finishes
+    void submit(const char* name, JobFunction function, Counter* pCounter = nullptr);
+
+    /// \desc queues a job once every job tracked by a counter has finished
+    /// \param dependency counter that must reach zero first
+    /// \param name label passed to the timing callback, must outlive the job
+    /// \param function work to run
+    /// \param pCounter optional counter to track the job with, incremented immediately
+    void submitAfter(Counter& dependency, const char* name, JobFunction function, Counter* pCounter = nullptr);
+
+    /// \desc splits [0, count) into chunks of grainSize and queues a job per chunk
+    /// \param name label passed to the timing callback, must outlive the jobs
+    /// \param count number of items to process
+    /// \param grainSize number of items per job (at least 1)
+    /// \param function work to run on each chunk
+    /// \param pCounter counter to track the chunks with
+    void parallelFor(const char* name, size_t count, size_t grainSize, const RangeFunction& function, Counter* pCounter);
+
+    /// \desc runs a parallel for and waits for it to finish
+    void parallelForAndWait(const char* name, size_t count, size_t grainSize, const RangeFunction& function);
+
+    /// \desc blocks until the counter reaches zero, running queued jobs in the meantime
+    void wait(Counter& counter);
+
+    /// \desc sets the hook called after every job, nullptr disables timing
+    void setTimingCallback(TimingCallback callback) { _timingCallback.store(callback, std::memory_order_release); }
+
+    /// \desc number of worker threads
+    [[nodiscard]] unsigned int getNumWorkers() const { return (unsigned int)_workers.size(); }
+
+private:
+    /// \desc a queued unit of work
+    struct Job {
+        /// \desc work to run
+        JobFunction function;
+        /// \desc label for the timing callback
+        const char* name;
+        /// \desc counter to decrement once the job finishes, may be null
+        Counter* pCounter;
+    };
+    /// \desc a worker's deque of jobs
+    struct WorkerQueue {
+        /// \desc guards the deque, owner and thieves work on opposite ends so contention is rare
+        std::mutex mutex;
+        /// \desc jobs pushed by or assigned to the worker
+        std::deque<Job> jobs;
+    };
+
+    /// \desc one queue per worker
+    std::vector<std::unique_ptr<WorkerQueue>> _queues;
+    /// \desc worker threads
+    std::vector<std::thread> _workers;
+    /// \desc cleared to shut the workers down
+    std::atomic<bool> _isRunning;
+    /// \desc number of jobs sitting in any queue
+    std::atomic<int> _numQueuedJobs;
+    /// \desc queue the next job from a non-worker thread goes to
+    std::atomic<unsigned int> _nextExternalQueue;
+    /// \desc lets idle workers sleep until a job is queued
+    std::mutex _sleepMutex;
+    /// \desc signaled whenever a job is queued
+    std::condition_variable _sleepCondition;
+    /// \desc hook called after every job
+    std::atomic<TimingCallback> _timingCallback;
+
+    /// \desc main loop of worker threads
+    void _workerLoop(int workerIndex);
+    /// \desc pushes a job onto the calling worker's queue, or a round robin queue for other threads
+    void _push(Job job);
+    /// \desc pops from the caller's own queue first and steals from the others otherwise
+    bool _tryGetJob(Job& job);
+    /// \desc runs a job, reports its timing and retires it from its counter
+    void _execute(Job& job);
+    /// \desc marks one job of a counter as finished and releases its continuations at zero
+    void _retire(Counter* pCounter);
+};
+
+#endif //A3_JOB_SYSTEM_H
@@ -0,0 +1,184 @@
+#include "Profiler.h"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// \desc zones per block of a track, blocks are allocated as the track fills up
+static constexpr size_t ZONES_PER_CHUNK = 16384;
+/// \desc blocks per track, once every block is used the track wraps around
+static constexpr size_t MAX_CHUNKS = 64;
+/// \desc zones a track holds before the oldest are overwritten
+static constexpr size_t TRACK_CAPACITY = ZONES_PER_CHUNK * MAX_CHUNKS;
+
+/// \desc ring of zones recorded by a single writer.  the writer publishes each zone by
+/// bumping numZones so a reader never sees one that is half written, and blocks are never
+/// moved or freed while the program runs so a reader never needs a lock.  zone i lives in
+/// slot i % TRACK_CAPACITY, so once a track wraps a reader checks numZones again after
+/// copying to tell which of the zones it copied may have been overwritten meanwhile
+struct Profiler::Track {
+    /// \desc name shown for the track in the trace
+    char name[48];
+    /// \desc id of the track in the trace
+    int threadId;
+    /// \desc blocks of zones, allocated by the writer
+    std::atomic<Profiler::Zone*> chunks[MAX_CHUNKS];
+    /// \desc number of zones published since the track was created, wrapped ones included
+    std::atomic<size_t> numZones;
+
+    Track() : name{}, threadId(0), numZones(0) {
+        for(auto& chunk : chunks) chunk.store(nullptr, std::memory_order_relaxed);
+    }
+    ~Track() {
+        for(auto& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+    }
+};
+
+std::atomic<bool> Profiler::sIsEnabled(false);
+std::atomic<uint64_t> Profiler::sFrameNumber(0);
+
+/// \desc time every zone is measured from
+static const std::chrono::steady_clock::time_point sEpoch = std::chrono::steady_clock::now();
+/// \desc guards the list of tracks, only taken when a track is created and when writing a trace
+static std::mutex sTracksMutex;
+/// \desc every track created so far, kept after their threads exit
+static std::vector<std::unique_ptr<Profiler::Track>> sTracks;
+
+/// \desc track of the calling thread, null until it records its first zone
+static thread_local Profiler::Track* tpThreadTrack = nullptr;
+/// \desc name given to the calling thread before it registered
+static thread_local char tThreadName[48] = "";
+/// \desc frame the calling thread's zones are tagged with, or NO_THREAD_FRAME to use the shared one
+static constexpr uint64_t NO_THREAD_FRAME = UINT64_MAX;
+static thread_local uint64_t tThreadFrameNumber = NO_THREAD_FRAME;
+
+/// \desc creates and registers a track
+static Profiler::Track* addTrack(const char* name) {
+    auto pTrack = std::make_unique<Profiler::Track>();
+
+    std::lock_guard<std::mutex> lock(sTracksMutex);
+    pTrack->threadId = (int)sTracks.size() + 1;
+    if(name[0] != '\0') {
+        snprintf(pTrack->name, sizeof(pTrack->name), "%s", name);
+    } else {
+        snprintf(pTrack->name, sizeof(pTrack->name), "thread %d", pTrack->threadId);
+    }
+    sTracks.push_back(std::move(pTrack));
+    return sTracks.back().get();
+}
+
+/// \desc writes a string as a JSON string literal
+static void writeJsonString(FILE* pFile, const char* string) {
+    fputc('"', pFile);
+    for(const char* pChar = string; *pChar != '\0'; pChar++) {
+        if(*pChar == '"' || *pChar == '\\') fputc('\\', pFile);
+        if((unsigned char)*pChar >= 0x20) fputc(*pChar, pFile);
+    }
+    fputc('"', pFile);
+}
+
+void Profiler::setThreadName(const char* name, const int index) {
+    if(tpThreadTrack != nullptr) return;
+
+    if(index >= 0) {
+        snprintf(tThreadName, sizeof(tThreadName), "%s %d", name, index);
+    } else {
+        snprintf(tThreadName, sizeof(tThreadName), "%s", name);
+    }
+}
+
+void Profiler::setThreadFrameNumber(const uint64_t frameNumber) {
+    tThreadFrameNumber = frameNumber;
+}
+
+uint64_t Profiler::getFrameNumber() {
+    return tThreadFrameNumber != NO_THREAD_FRAME ? tThreadFrameNumber : sFrameNumber.load(std::memory_order_relaxed);
+}
+
+int64_t Profiler::now() {
+    return toProfilerTime(std::chrono::steady_clock::now());
+}
+
+int64_t Profiler::toProfilerTime(const std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - sEpoch).count();
+}
+
+Profiler::Track* Profiler::createTrack(const char* name) {
+    return addTrack(name);
+}
+
+void Profiler::record(const char* name, const int64_t start, const int64_t end) {
+    if(tpThreadTrack == nullptr) tpThreadTrack = addTrack(tThreadName);
+    record(tpThreadTrack, name, start, end, getFrameNumber());
+}
+
+void Profiler::record(Track* pTrack, const char* name, const int64_t start, const int64_t end, const uint64_t frameNumber) {
+    // only one thread writes numZones, so a relaxed load sees its own last store
+    const size_t index = pTrack->numZones.load(std::memory_order_relaxed);
+    const size_t slot = index % TRACK_CAPACITY;
+    const size_t chunkIndex = slot / ZONES_PER_CHUNK;
+
+    Zone* pChunk = pTrack->chunks[chunkIndex].load(std::memory_order_relaxed);
+    if(pChunk == nullptr) {
+        pChunk = new Zone[ZONES_PER_CHUNK];
+        pTrack->chunks[chunkIndex].store(pChunk, std::memory_order_relaxed);
+    }
+    if(index == TRACK_CAPACITY) {
+        fprintf(stdout, "[INFO]: Profiler track \"%s\" wrapped, only its newest %zu zones are kept\n", pTrack->name, TRACK_CAPACITY);
+    }
+    pChunk[slot % ZONES_PER_CHUNK] = {name, start, end, frameNumber};
+
+    // publishes the zone and the block it sits in
+    pTrack->numZones.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::writeChromeTrace(const char* path) {
+    FILE* pFile = fopen(path, "w");
+    if(pFile == nullptr) {
+        fprintf(stderr, "[ERROR]: Could not open profile output \"%s\"\n", path);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sTracksMutex);
+
+    fprintf(pFile, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool isFirstEvent = true;
+    size_t totalZones = 0;
+    std::vector<Zone> zones;
+    for(const auto& pTrack : sTracks) {
+        fprintf(pFile, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": ",
+                isFirstEvent ? "" : ",\n", pTrack->threadId);
+        writeJsonString(pFile, pTrack->name);
+        fprintf(pFile, "}}");
+        isFirstEvent = false;
+
+        // copy first so the writer can only have overwritten zones while they were being copied,
+        // then keep the ones past where it has got to since
+        const size_t numZones = pTrack->numZones.load(std::memory_order_acquire);
+        const size_t firstZone = numZones > TRACK_CAPACITY ? numZones - TRACK_CAPACITY : 0;
+        zones.clear();
+        for(size_t i = firstZone; i < numZones; i++) {
+            const size_t slot = i % TRACK_CAPACITY;
+            zones.push_back(pTrack->chunks[slot / ZONES_PER_CHUNK].load(std::memory_order_relaxed)[slot % ZONES_PER_CHUNK]);
+        }
+        const size_t numZonesAfter = pTrack->numZones.load(std::memory_order_acquire);
+        const size_t firstIntactZone = numZonesAfter >= TRACK_CAPACITY ? numZonesAfter - TRACK_CAPACITY + 1 : 0;
+        const size_t numSkipped = firstIntactZone > firstZone ? firstIntactZone - firstZone : 0;
+
+        for(size_t i = numSkipped; i < zones.size(); i++) {
+            const Zone& zone = zones[i];
+            fprintf(pFile, ",\n{\"ph\": \"X\", \"name\": ");
+            writeJsonString(pFile, zone.name);
+            fprintf(pFile, ", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"frame\": %llu}}",
+                    pTrack->threadId, (double)zone.start / 1000.0, (double)(zone.end - zone.start) / 1000.0,
+                    (unsigned long long)zone.frameNumber);
+        }
+        if(numSkipped < zones.size()) totalZones += zones.size() - numSkipped;
+    }
+    fprintf(pFile, "\n]}\n");
+    fclose(pFile);
+
+    fprintf(stdout, "[INFO]: Wrote %zu profiler zones from %zu track(s) to %s\n", totalZones, sTracks.size(), path);
+    return true;
+}
@@ -0,0 +1,123 @@
+#ifndef A3_PROFILER_H
+#define A3_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// \desc low overhead CPU profiler built from scoped zones.  every thread records into its
+/// own ring buffer without taking a lock, each zone tagged with the frame it belongs to, and
+/// the newest zones can be written out as a Chrome trace (chrome://tracing, Perfetto) at any time.
+///
+/// zones are placed with A3_PROFILE_SCOPE and A3_PROFILE_FUNCTION, which compile to nothing
+/// unless A3_ENABLE_PROFILER is defined.  when compiled in, nothing is recorded until the
+/// profiler is enabled at runtime.  the CSCI441 headers time their own hot paths through
+/// CSCI441_TRACE_SCOPE, which this header routes into the profiler.
+class Profiler {
+public:
+    /// \desc a finished zone
+    struct Zone {
+        /// \desc name of the zone, must be a string that lives for the whole run
+        const char* name;
+        /// \desc nanoseconds since the profiler's epoch the zone began at
+        int64_t start;
+        /// \desc nanoseconds since the profiler's epoch the zone ended at
+        int64_t end;
+        /// \desc frame the zone was recorded in, 0 during startup
+        uint64_t frameNumber;
+    };
+
+    /// \desc a row of zones in the trace, every thread gets its own
+    struct Track;
+
+    /// \desc turns recording on or off for every thread
+    static void setEnabled(bool isEnabled) { sIsEnabled.store(isEnabled, std::memory_order_relaxed); }
+    /// \desc true while zones are being recorded
+    static bool isEnabled() { return sIsEnabled.load(std::memory_order_relaxed); }
+
+    /// \desc names the calling thread in the trace
+    /// \param name name to show, copied
+    /// \param index appended to the name if not negative, for pools of identical threads
+    /// \note only takes effect before the thread records its first zone
+    static void setThreadName(const char* name, int index = -1);
+
+    /// \desc sets the frame zones are tagged with, called by the thread driving the frames
+    static void setFrameNumber(uint64_t frameNumber) { sFrameNumber.store(frameNumber, std::memory_order_relaxed); }
+    /// \desc tags the calling thread's zones with a frame of its own instead, for a thread running behind the others
+    static void setThreadFrameNumber(uint64_t frameNumber);
+    /// \desc frame the calling thread's zones are tagged with
+    static uint64_t getFrameNumber();
+
+    /// \desc nanoseconds since the profiler's epoch
+    static int64_t now();
+    /// \desc converts a steady clock time point to nanoseconds since the profiler's epoch
+    static int64_t toProfilerTime(std::chrono::steady_clock::time_point time);
+
+    /// \desc records a finished zone on the calling thread, tagged with the thread's frame
+    /// \param name name of the zone, must be a string that lives for the whole run
+    /// \param start time the zone began, from now()
+    /// \param end time the zone ended, from now()
+    static void record(const char* name, int64_t start, int64_t end);
+
+    /// \desc creates a track that is not tied to a thread, for timings measured elsewhere such as on the GPU
+    /// \param name name to show for the track
+    /// \return the track, it lives for the rest of the program
+    static Track* createTrack(const char* name);
+    /// \desc records a finished zone on a track
+    /// \param pTrack track to record on
+    /// \param name name of the zone, must be a string that lives for the whole run
+    /// \param start time the zone began, in profiler time
+    /// \param end time the zone ended, in profiler time
+    /// \param frameNumber frame the zone belongs to
+    /// \note a track must only ever be written by one thread at a time
+    static void record(Track* pTrack, const char* name, int64_t start, int64_t end, uint64_t frameNumber);
+
+    /// \desc writes the zones every track still holds as a Chrome trace
+    /// \param path file to write
+    /// \return true if the file was written
+    /// \note safe to call while other threads keep recording, their newest zones may be left out
+    static bool writeChromeTrace(const char* path);
+
+private:
+    /// \desc true while zones are being recorded
+    static std::atomic<bool> sIsEnabled;
+    /// \desc frame zones are tagged with unless their thread has its own
+    static std::atomic<uint64_t> sFrameNumber;
+};
+
+/// \desc records the time from its construction to its destruction as a zone
+class ProfileZone {
+public:
+    /// \param name name of the zone, must be a string that lives for the whole run
+    explicit ProfileZone(const char* name)
+            : _name(Profiler::isEnabled() ? name : nullptr),
+              _start(_name != nullptr ? Profiler::now() : 0) {}
+    ~ProfileZone() {
+        if(_name != nullptr) Profiler::record(_name, _start, Profiler::now());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    /// \desc name of the zone, null if the profiler was disabled when it began
+    const char* _name;
+    /// \desc time the zone began
+    int64_t _start;
+};
+
+#ifdef A3_ENABLE_PROFILER
+#define A3_PROFILE_CONCAT_INNER(a, b) a##b
+#define A3_PROFILE_CONCAT(a, b) A3_PROFILE_CONCAT_INNER(a, b)
+/// \desc profiles the rest of the enclosing scope under a name
+#define A3_PROFILE_SCOPE(name) ProfileZone A3_PROFILE_CONCAT(profileZone, __LINE__)(name)
+/// \desc profiles the rest of the enclosing function under its name
+#define A3_PROFILE_FUNCTION() A3_PROFILE_SCOPE(__func__)
+/// \desc profiles the hot paths of the CSCI441 headers, which include this header when built with CSCI441_TRACE_HEADER set
+#define CSCI441_TRACE_SCOPE(name) A3_PROFILE_SCOPE(name)
+#else
+#define A3_PROFILE_SCOPE(name) ((void)0)
+#define A3_PROFILE_FUNCTION() ((void)0)
+#endif
+
+#endif //A3_PROFILER_H
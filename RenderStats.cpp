@@ -0,0 +1,22 @@
+#include "RenderStats.h"
+
+#include <CSCI441/ShaderProgram.hpp>
+
+RenderStats::Counters RenderStats::sCurrentFrame = {};
+RenderStats::Counters RenderStats::sLastFrame = {};
+
+void RenderStats::install() {
+    CSCI441::ShaderProgram::setUniformUploadCallback(countUniformUpload);
+    CSCI441::ShaderProgram::setUseProgramCallback(countProgramBind);
+}
+
+GLuint64 RenderStats::countTriangles(const GLenum mode, const GLsizei numVertices) {
+    if(numVertices < 3) return 0;
+
+    switch(mode) {
+        case GL_TRIANGLES:      return (GLuint64)numVertices / 3;
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:   return (GLuint64)numVertices - 2;
+        default:                return 0;
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef A3_RENDER_STATS_H
+#define A3_RENDER_STATS_H
+
+#include <GL/glew.h>
+
+#include <CSCI441/objects.hpp>
+
+/// \desc per-frame counts of the work handed to OpenGL: draw calls, instances, triangles,
+/// uniform uploads, program and vertex array binds and bytes uploaded to buffers.
+///
+/// draws and binds are counted by calling the counted wrappers below in place of the GL
+/// calls, uniform uploads and program binds made through a CSCI441::ShaderProgram are
+/// counted by its hooks once install() has been called.  the counters are not atomic,
+/// only the thread that owns the OpenGL context may count.
+class RenderStats {
+public:
+    /// \desc the counts of one frame
+    struct Counters {
+        /// \desc draw calls issued
+        GLuint64 drawCalls;
+        /// \desc instances drawn, one per draw call unless instanced
+        GLuint64 instances;
+        /// \desc triangles submitted, over every instance
+        GLuint64 triangles;
+        /// \desc uniform values uploaded
+        GLuint64 uniformUploads;
+        /// \desc bytes of uniform values uploaded
+        GLuint64 uniformBytes;
+        /// \desc shader programs made current
+        GLuint64 programBinds;
+        /// \desc vertex arrays bound
+        GLuint64 vertexArrayBinds;
+        /// \desc bytes copied into buffers
+        GLuint64 bytesUploaded;
+    };
+
+    /// \desc sets the CSCI441::ShaderProgram hooks so its uploads and binds are counted
+    static void install();
+
+    /// \desc clears the counts for a new frame
+    static void beginFrame() { sCurrentFrame = {}; }
+    /// \desc keeps the counts of the frame just drawn as the last frame's
+    static void endFrame() { sLastFrame = sCurrentFrame; }
+    /// \desc counts of the frame being drawn so far
+    static const Counters& getCurrentFrame() { return sCurrentFrame; }
+    /// \desc counts of the last finished frame
+    static const Counters& getLastFrame() { return sLastFrame; }
+
+    /// \desc counts a draw call
+    /// \param numTriangles triangles in a single instance
+    /// \param numInstances instances drawn by the call
+    static void countDraw(GLuint64 numTriangles, GLuint64 numInstances = 1) {
+        sCurrentFrame.drawCalls++;
+        sCurrentFrame.instances += numInstances;
+        sCurrentFrame.triangles += numTriangles * numInstances;
+    }
+    /// \desc counts a uniform upload
+    /// \param numBytes size of the uploaded values
+    static void countUniformUpload(GLsizeiptr numBytes) {
+        sCurrentFrame.uniformUploads++;
+        sCurrentFrame.uniformBytes += (GLuint64)numBytes;
+    }
+    /// \desc counts a shader program being made current
+    static void countProgramBind() { sCurrentFrame.programBinds++; }
+    /// \desc counts a vertex array being bound
+    static void countVertexArrayBind() { sCurrentFrame.vertexArrayBinds++; }
+    /// \desc counts data copied into a buffer
+    /// \param numBytes size of the copied data
+    static void countBufferUpload(GLsizeiptr numBytes) { sCurrentFrame.bytesUploaded += (GLuint64)numBytes; }
+
+    /// \desc number of triangles a primitive mode makes out of a number of vertices, 0 for points and lines
+    static GLuint64 countTriangles(GLenum mode, GLsizei numVertices);
+
+private:
+    /// \desc counts of the frame being drawn
+    static Counters sCurrentFrame;
+    /// \desc counts of the last finished frame
+    static Counters sLastFrame;
+};
+
+//*************************************************************************************
+//
+// Counted GL calls - drop in replacements that also update the render stats
+
+/// \desc glDrawArrays, counted
+inline void countedDrawArrays(GLenum mode, GLint first, GLsizei count) {
+    glDrawArrays(mode, first, count);
+    RenderStats::countDraw(RenderStats::countTriangles(mode, count));
+}
+
+/// \desc glDrawElements, counted
+inline void countedDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+    glDrawElements(mode, count, type, indices);
+    RenderStats::countDraw(RenderStats::countTriangles(mode, count));
+}
+
+/// \desc glBindVertexArray, counted
+inline void countedBindVertexArray(GLuint vertexArray) {
+    glBindVertexArray(vertexArray);
+    RenderStats::countVertexArrayBind();
+}
+
+/// \desc CSCI441::drawSolidCube, counted as the single indexed draw of 12 triangles it makes
+inline void countedDrawSolidCube(GLfloat sideLength) {
+    CSCI441::drawSolidCube(sideLength);
+    RenderStats::countVertexArrayBind();
+    RenderStats::countDraw(12);
+}
+
+/// \desc CSCI441::drawSolidSphere, counted as a draw of two triangles per stack and slice
+inline void countedDrawSolidSphere(GLfloat radius, GLint stacks, GLint slices) {
+    CSCI441::drawSolidSphere(radius, stacks, slices);
+    RenderStats::countVertexArrayBind();
+    RenderStats::countDraw((GLuint64)stacks * (GLuint64)slices * 2);
+}
+
+#endif //A3_RENDER_STATS_H
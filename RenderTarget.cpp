@@ -0,0 +1,59 @@
+#include "RenderTarget.h"
+
+#include <cstdio>
+
+RenderTarget::RenderTarget(GLenum colorFormat, GLenum depthFormat) {
+    _colorFormat = colorFormat;
+    _depthFormat = depthFormat;
+    _width = 0;
+    _height = 0;
+
+    glGenFramebuffers(1, &_fbo);
+    glGenRenderbuffers(1, &_colorRenderbuffer);
+    glGenRenderbuffers(1, &_depthRenderbuffer);
+}
+
+RenderTarget::~RenderTarget() {
+    glDeleteFramebuffers(1, &_fbo);
+    glDeleteRenderbuffers(1, &_colorRenderbuffer);
+    glDeleteRenderbuffers(1, &_depthRenderbuffer);
+}
+
+void RenderTarget::resize(GLsizei width, GLsizei height) {
+    if(width == _width && height == _height) return;
+    // a minimized window has no area, keep the old storage until it comes back
+    if(width <= 0 || height <= 0) return;
+
+    _width = width;
+    _height = height;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, _colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, _colorFormat, _width, _height);
+    glBindRenderbuffer(GL_RENDERBUFFER, _depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, _depthFormat, _width, _height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthRenderbuffer);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if(status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "[ERROR]: Render target %dx%d is incomplete, status 0x%x\n", _width, _height, status);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void RenderTarget::bind() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+}
+
+void RenderTarget::blitToDefaultFramebuffer() const {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glDrawBuffer(GL_BACK);
+    glBlitFramebuffer(0, 0, _width, _height, 0, 0, _width, _height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
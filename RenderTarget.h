@@ -0,0 +1,53 @@
+#ifndef A3_RENDER_TARGET_H
+#define A3_RENDER_TARGET_H
+
+#include <GL/glew.h>
+
+/// \desc offscreen framebuffer with a color and a depth attachment that follows the
+/// size of the window and is copied to the default framebuffer once a frame is done
+class RenderTarget {
+public:
+    /// \desc creates the framebuffer, storage is allocated on the first resize()
+    /// \param colorFormat sized internal format of the color attachment (e.g. GL_RGBA8)
+    /// \param depthFormat sized internal format of the depth attachment (e.g. GL_DEPTH_COMPONENT32F)
+    RenderTarget(GLenum colorFormat, GLenum depthFormat);
+    ~RenderTarget();
+
+    RenderTarget(const RenderTarget&) = delete;
+    RenderTarget& operator=(const RenderTarget&) = delete;
+
+    /// \desc reallocates the attachments for a new size, does nothing if the size is unchanged
+    /// \param width new width in pixels
+    /// \param height new height in pixels
+    void resize(GLsizei width, GLsizei height);
+
+    /// \desc binds the framebuffer for drawing
+    void bind() const;
+
+    /// \desc copies the color attachment into the back buffer of the default framebuffer
+    /// \note leaves the default framebuffer bound
+    void blitToDefaultFramebuffer() const;
+
+    /// \desc handle of the framebuffer object
+    [[nodiscard]] GLuint getFramebufferHandle() const { return _fbo; }
+    /// \desc current width in pixels
+    [[nodiscard]] GLsizei getWidth() const { return _width; }
+    /// \desc current height in pixels
+    [[nodiscard]] GLsizei getHeight() const { return _height; }
+
+private:
+    /// \desc framebuffer object
+    GLuint _fbo;
+    /// \desc renderbuffer holding the color attachment
+    GLuint _colorRenderbuffer;
+    /// \desc renderbuffer holding the depth attachment
+    GLuint _depthRenderbuffer;
+    /// \desc format of the color attachment
+    GLenum _colorFormat;
+    /// \desc format of the depth attachment
+    GLenum _depthFormat;
+    /// \desc current size of the attachments
+    GLsizei _width, _height;
+};
+
+#endif //A3_RENDER_TARGET_H
@@ -0,0 +1,248 @@
+#include "ShaderHotReloader.h"
+
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+/// \desc time given for the rest of a save to land after the first change is seen, editors
+/// often write a file in several steps
+static constexpr std::chrono::milliseconds SETTLE_TIME(50);
+/// \desc longest the watch thread goes without checking whether it should stop
+static constexpr std::chrono::milliseconds WATCH_INTERVAL(250);
+
+ShaderHotReloader::ShaderHotReloader()
+        : _pCompileWindow(nullptr),
+          _isRunning(false),
+          _hasPendingReloads(false) {
+}
+
+ShaderHotReloader::~ShaderHotReloader() {
+    stop();
+}
+
+void ShaderHotReloader::addProgram(const char* vertexShaderFilename, const char* fragmentShaderFilename,
+                                   std::vector<std::string> defines, ReloadCallback callback) {
+    WatchedProgram program{vertexShaderFilename, fragmentShaderFilename, std::move(defines), std::move(callback), {}};
+    _loadSources(program);
+    _programs.push_back(std::move(program));
+}
+
+bool ShaderHotReloader::start(GLFWwindow* pSharedWindow) {
+    if( _isRunning.load(std::memory_order_acquire) || _programs.empty() ) return false;
+
+    // the other hints still hold from creating the shared window, so the contexts match
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    _pCompileWindow = glfwCreateWindow(1, 1, "Shader Hot Reload", nullptr, pSharedWindow);
+    if( _pCompileWindow == nullptr ) {
+        fprintf(stderr, "[ERROR]: Could not create a shared context for shader hot reload\n");
+        return false;
+    }
+
+    _isRunning.store(true, std::memory_order_release);
+    _watchThread = std::thread(&ShaderHotReloader::_watchLoop, this);
+    fprintf(stdout, "[INFO]: Watching %zu shader program(s) for changes\n", _programs.size());
+    return true;
+}
+
+void ShaderHotReloader::stop() {
+    if( _watchThread.joinable() ) {
+        _isRunning.store(false, std::memory_order_release);
+        _watchThread.join();
+    }
+    if( _pCompileWindow != nullptr ) {
+        glfwDestroyWindow(_pCompileWindow);
+        _pCompileWindow = nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(_reloadMutex);
+    for(const Reload& reload : _pendingReloads) {
+        delete reload.pShaderProgram;
+    }
+    _pendingReloads.clear();
+    _hasPendingReloads.store(false, std::memory_order_relaxed);
+}
+
+void ShaderHotReloader::applyReloads() {
+    if( !_hasPendingReloads.load(std::memory_order_acquire) ) return;
+
+    std::vector<Reload> reloads;
+    {
+        // the watch thread only holds the lock to queue, but a frame must never wait on it
+        std::unique_lock<std::mutex> lock(_reloadMutex, std::try_to_lock);
+        if( !lock.owns_lock() ) return;
+        reloads.swap(_pendingReloads);
+        _hasPendingReloads.store(false, std::memory_order_relaxed);
+    }
+
+    A3_PROFILE_SCOPE("applyShaderReloads");
+    for(const Reload& reload : reloads) {
+        _programs[reload.programIndex].callback(reload.pShaderProgram);
+    }
+}
+
+bool ShaderHotReloader::hasPendingReloads() const {
+    return _hasPendingReloads.load(std::memory_order_acquire);
+}
+
+void ShaderHotReloader::_watchLoop() {
+    Profiler::setThreadName("shaderReload");
+    glfwMakeContextCurrent(_pCompileWindow);
+
+#ifdef __linux__
+    const int inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if( inotifyHandle < 0 ) {
+        fprintf(stderr, "[WARN]: inotify is not available, polling shader files for changes instead\n");
+    }
+    // watching the directories rather than the files sees saves that replace the file
+    std::set<std::string> watchedDirectories;
+    std::map<int, std::string> directoryByWatch;
+    const auto watchDirectories = [&]() {
+        if( inotifyHandle < 0 ) return;
+        for(const WatchedProgram& program : _programs) {
+            for(const auto& pSource : program.sources) {
+                for(const std::string& file : pSource->getFiles()) {
+                    std::string directory = std::filesystem::path(file).parent_path().generic_string();
+                    if( directory.empty() ) directory = ".";
+                    if( !watchedDirectories.insert(directory).second ) continue;
+                    const int watchHandle = inotify_add_watch(inotifyHandle, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+                    if( watchHandle < 0 ) {
+                        fprintf(stderr, "[WARN]: Could not watch shader directory %s\n", directory.c_str());
+                    } else {
+                        directoryByWatch[watchHandle] = directory;
+                    }
+                }
+            }
+        }
+    };
+    watchDirectories();
+#endif
+
+    std::vector<bool> isChanged(_programs.size(), false);
+    while( _isRunning.load(std::memory_order_acquire) ) {
+        bool isAnyChanged = false;
+
+#ifdef __linux__
+        if( inotifyHandle >= 0 ) {
+            pollfd pollHandle{inotifyHandle, POLLIN, 0};
+            if( poll(&pollHandle, 1, (int)WATCH_INTERVAL.count()) <= 0 ) continue;
+
+            // let the rest of the save land so it is read in one piece
+            std::this_thread::sleep_for(SETTLE_TIME);
+
+            alignas(inotify_event) char buffer[4096];
+            ssize_t length;
+            while( (length = read(inotifyHandle, buffer, sizeof(buffer))) > 0 ) {
+                for(const char* pEvent = buffer; pEvent < buffer + length; ) {
+                    const auto* pInotifyEvent = reinterpret_cast<const inotify_event*>(pEvent);
+                    pEvent += sizeof(inotify_event) + pInotifyEvent->len;
+                    const auto directoryIter = directoryByWatch.find(pInotifyEvent->wd);
+                    if( pInotifyEvent->len == 0 || directoryIter == directoryByWatch.end() ) continue;
+
+                    const std::string path = (std::filesystem::path(directoryIter->second) / pInotifyEvent->name).lexically_normal().generic_string();
+                    for(size_t i = 0; i < _programs.size(); i++) {
+                        if( _dependsOn(_programs[i], path) ) {
+                            isChanged[i] = true;
+                            isAnyChanged = true;
+                        }
+                    }
+                }
+            }
+        } else
+#endif
+        {
+            std::this_thread::sleep_for(WATCH_INTERVAL);
+            for(size_t i = 0; i < _programs.size(); i++) {
+                for(const auto& pSource : _programs[i].sources) {
+                    if( pSource->isStale() ) {
+                        isChanged[i] = true;
+                        isAnyChanged = true;
+                    }
+                }
+            }
+        }
+
+        if( !isAnyChanged ) continue;
+        for(size_t i = 0; i < _programs.size(); i++) {
+            if( !isChanged[i] ) continue;
+            isChanged[i] = false;
+            _reloadProgram(i);
+        }
+#ifdef __linux__
+        // an edit may have pulled in a file from another directory
+        watchDirectories();
+#endif
+    }
+
+#ifdef __linux__
+    if( inotifyHandle >= 0 ) close(inotifyHandle);
+#endif
+    glfwMakeContextCurrent(nullptr);
+}
+
+void ShaderHotReloader::_reloadProgram(const size_t programIndex) {
+    A3_PROFILE_SCOPE("reloadShaderProgram");
+    WatchedProgram& program = _programs[programIndex];
+    fprintf(stdout, "[INFO]: Reloading shader program %s / %s\n", program.vertexShaderFilename.c_str(), program.fragmentShaderFilename.c_str());
+
+    auto pShaderProgram = new CSCI441::ShaderProgram(program.vertexShaderFilename.c_str(), program.fragmentShaderFilename.c_str(), program.defines);
+    // remember the files even if the edit broke the program, so fixing it reloads it again
+    _loadSources(program);
+
+    GLint linkStatus = GL_FALSE;
+    if( pShaderProgram->getShaderProgramHandle() != 0 ) {
+        glGetProgramiv(pShaderProgram->getShaderProgramHandle(), GL_LINK_STATUS, &linkStatus);
+    }
+    if( linkStatus != GL_TRUE ) {
+        fprintf(stderr, "[ERROR]: Shader program %s / %s did not link, keeping the previous program\n",
+                program.vertexShaderFilename.c_str(), program.fragmentShaderFilename.c_str());
+        delete pShaderProgram;
+        return;
+    }
+
+    // the program must be complete before another context can use it
+    glFinish();
+
+    std::lock_guard<std::mutex> lock(_reloadMutex);
+    // a newer build of the same program replaces one the render thread has not picked up yet
+    for(Reload& reload : _pendingReloads) {
+        if( reload.programIndex == programIndex ) {
+            delete reload.pShaderProgram;
+            reload.pShaderProgram = pShaderProgram;
+            return;
+        }
+    }
+    _pendingReloads.push_back({programIndex, pShaderProgram});
+    _hasPendingReloads.store(true, std::memory_order_release);
+
+    // an idle main thread sleeps in glfwWaitEvents, wake it so it draws the frame that applies the reload
+    glfwPostEmptyEvent();
+}
+
+void ShaderHotReloader::_loadSources(WatchedProgram& program) const {
+    std::vector< std::shared_ptr<const CSCI441::ShaderSource> > sources;
+    for(const std::string& filename : {program.vertexShaderFilename, program.fragmentShaderFilename}) {
+        auto pSource = CSCI441::ShaderSourceCache::load(filename.c_str(), program.defines);
+        if( pSource != nullptr ) sources.push_back(std::move(pSource));
+    }
+    // keep the files known so far if a file went missing halfway through a save
+    if( sources.size() == 2 || program.sources.empty() ) program.sources = std::move(sources);
+}
+
+bool ShaderHotReloader::_dependsOn(const WatchedProgram& program, const std::string& path) {
+    for(const auto& pSource : program.sources) {
+        const std::vector<std::string> files = pSource->getFiles();
+        if( std::find(files.begin(), files.end(), path) != files.end() ) return true;
+    }
+    return false;
+}
@@ -0,0 +1,113 @@
+#ifndef A3_SHADER_HOT_RELOADER_H
+#define A3_SHADER_HOT_RELOADER_H
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <CSCI441/ShaderProgram.hpp>
+#include <CSCI441/ShaderSourceCache.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// \desc recompiles shader programs in the background when their source files change.
+///
+/// a thread watches the directories of every file a program was built from, including the files
+/// it #includes, with inotify (polling modification times where inotify is not available).  when
+/// one changes the program is compiled again on a hidden window whose context shares objects with
+/// the render context, so the render thread never waits on a compile.  a program that links is
+/// queued and handed over by applyReloads() at the next frame boundary, one that fails is thrown
+/// away and the old program stays in use.  queuing a program wakes a main thread waiting on
+/// events, so an idle window draws the frame that picks it up.
+class ShaderHotReloader {
+public:
+    /// \desc takes over a recompiled program, called by the thread that calls applyReloads()
+    /// \param pShaderProgram linked program that now belongs to the callback
+    using ReloadCallback = std::function<void(CSCI441::ShaderProgram* pShaderProgram)>;
+
+    ShaderHotReloader();
+    /// \desc stops watching if it has not been stopped already
+    ~ShaderHotReloader();
+
+    ShaderHotReloader(const ShaderHotReloader&) = delete;
+    ShaderHotReloader& operator=(const ShaderHotReloader&) = delete;
+
+    /// \desc watches the source files of a vertex and fragment shader program, must be called before start()
+    /// \param vertexShaderFilename name of the file corresponding to the vertex shader
+    /// \param fragmentShaderFilename name of the file corresponding to the fragment shader
+    /// \param defines macros the program is compiled with, each as "NAME" or "NAME VALUE"
+    /// \param callback takes over the program each time it has been recompiled
+    void addProgram(const char* vertexShaderFilename, const char* fragmentShaderFilename,
+                    std::vector<std::string> defines, ReloadCallback callback);
+
+    /// \desc creates the compile context and starts watching, called by the main thread
+    /// \param pSharedWindow window whose context the compile context shares objects with
+    /// \return true if the files are being watched
+    /// \note must be called while the shared window's context is not current on any other thread
+    bool start(GLFWwindow* pSharedWindow);
+    /// \desc stops watching and destroys the compile context, called by the main thread
+    /// \note reloads that were never applied are deleted, so an OpenGL context must be current
+    void stop();
+
+    /// \desc hands every program recompiled since the last call to its callback, called by the
+    /// render thread at a frame boundary
+    /// \note never waits on the compile thread, a reload it cannot pick up now waits for the next frame
+    void applyReloads();
+    /// \desc true if a recompiled program is waiting for applyReloads(), callable from any thread
+    [[nodiscard]] bool hasPendingReloads() const;
+
+private:
+    /// \desc a program being watched
+    struct WatchedProgram {
+        /// \desc name of the file corresponding to the vertex shader
+        std::string vertexShaderFilename;
+        /// \desc name of the file corresponding to the fragment shader
+        std::string fragmentShaderFilename;
+        /// \desc macros the program is compiled with
+        std::vector<std::string> defines;
+        /// \desc takes over the program each time it has been recompiled
+        ReloadCallback callback;
+        /// \desc preprocessed sources the program was last built from, only touched by the watch thread once started
+        std::vector< std::shared_ptr<const CSCI441::ShaderSource> > sources;
+    };
+    /// \desc a recompiled program waiting for the render thread
+    struct Reload {
+        /// \desc index of the program in _programs
+        size_t programIndex;
+        /// \desc linked program
+        CSCI441::ShaderProgram* pShaderProgram;
+    };
+
+    /// \desc programs being watched
+    std::vector<WatchedProgram> _programs;
+    /// \desc hidden window owning the compile context
+    GLFWwindow* _pCompileWindow;
+    /// \desc thread watching the files and compiling the programs
+    std::thread _watchThread;
+    /// \desc true while the watch thread should keep running
+    std::atomic<bool> _isRunning;
+
+    /// \desc guards the pending reloads
+    std::mutex _reloadMutex;
+    /// \desc recompiled programs not yet handed over
+    std::vector<Reload> _pendingReloads;
+    /// \desc true if there may be pending reloads, lets the render thread skip the lock
+    std::atomic<bool> _hasPendingReloads;
+
+    /// \desc body of the watch thread
+    void _watchLoop();
+    /// \desc recompiles a program and queues it if it links
+    void _reloadProgram(size_t programIndex);
+    /// \desc loads the sources a program is built from, so the files it depends on are known
+    void _loadSources(WatchedProgram& program) const;
+    /// \desc true if a program is built from a file
+    /// \param path lexically normal path of the file
+    static bool _dependsOn(const WatchedProgram& program, const std::string& path);
+};
+
+#endif //A3_SHADER_HOT_RELOADER_H
@@ -0,0 +1,110 @@
+#ifndef A3_SNAPSHOT_BUFFER_H
+#define A3_SNAPSHOT_BUFFER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/// \desc triple buffer used to hand immutable snapshots from a single producer thread
+/// to a single consumer thread.  the producer always has a slot to write into, the
+/// consumer always holds the most recently published slot, and neither ever waits on
+/// the other while writing or reading a snapshot.
+/// \note slots are reused, so a snapshot's containers keep their capacity between frames
+template<typename T>
+class SnapshotBuffer {
+public:
+    SnapshotBuffer();
+
+    SnapshotBuffer(const SnapshotBuffer&) = delete;
+    SnapshotBuffer& operator=(const SnapshotBuffer&) = delete;
+
+    /// \desc returns the slot owned by the producer
+    /// \note the slot holds stale data from an earlier frame and must be fully rewritten
+    T& beginWrite() { return _slots[_writeIndex]; }
+
+    /// \desc makes the slot returned by beginWrite() the newest snapshot
+    /// \note if the consumer has not picked up the previous snapshot it is dropped
+    void publish();
+
+    /// \desc blocks until a snapshot newer than the last acquired one is available
+    /// \return the newest snapshot, or nullptr once the buffer is closed
+    /// \note the snapshot remains valid until the next call to acquire()
+    const T* acquire();
+
+    /// \desc blocks until the consumer has picked up the last published snapshot
+    /// \param timeout maximum time to wait
+    /// \return true if the snapshot was consumed, false on timeout or close
+    bool waitUntilConsumed(std::chrono::milliseconds timeout);
+
+    /// \desc wakes up any waiting thread and makes acquire() return nullptr
+    void close();
+
+private:
+    /// \desc the three snapshot slots
+    T _slots[3];
+    /// \desc slot being written by the producer
+    int _writeIndex;
+    /// \desc most recently published slot
+    int _readyIndex;
+    /// \desc slot being read by the consumer
+    int _readIndex;
+    /// \desc true if the ready slot has not been acquired yet
+    bool _hasNewSnapshot;
+    /// \desc true once close() has been called
+    bool _isClosed;
+
+    /// \desc guards the slot indices, held only while swapping them
+    std::mutex _mutex;
+    /// \desc signaled whenever a snapshot is published or acquired
+    std::condition_variable _condition;
+};
+
+template<typename T>
+inline SnapshotBuffer<T>::SnapshotBuffer()
+        : _writeIndex(0),
+          _readyIndex(1),
+          _readIndex(2),
+          _hasNewSnapshot(false),
+          _isClosed(false) {
+}
+
+template<typename T>
+inline void SnapshotBuffer<T>::publish() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::swap(_writeIndex, _readyIndex);
+        _hasNewSnapshot = true;
+    }
+    _condition.notify_all();
+}
+
+template<typename T>
+inline const T* SnapshotBuffer<T>::acquire() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this] { return _hasNewSnapshot || _isClosed; });
+    if(_isClosed) return nullptr;
+
+    std::swap(_readIndex, _readyIndex);
+    _hasNewSnapshot = false;
+    lock.unlock();
+
+    _condition.notify_all();
+    return &_slots[_readIndex];
+}
+
+template<typename T>
+inline bool SnapshotBuffer<T>::waitUntilConsumed(const std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _condition.wait_for(lock, timeout, [this] { return !_hasNewSnapshot || _isClosed; }) && !_isClosed;
+}
+
+template<typename T>
+inline void SnapshotBuffer<T>::close() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isClosed = true;
+    }
+    _condition.notify_all();
+}
+
+#endif //A3_SNAPSHOT_BUFFER_H
@@ -0,0 +1,186 @@
+#include "TextOverlay.h"
+
+#include "RenderStats.h"
+
+#include <cstddef>
+
+/// \desc first character in the font
+static constexpr char FIRST_GLYPH = ' ';
+/// \desc number of characters in the font
+static constexpr GLuint NUM_GLYPHS = 64;
+/// \desc size of a glyph cell in font pixels, one column and row wider than the glyph for spacing
+static constexpr GLuint CELL_WIDTH = 6, CELL_HEIGHT = 8;
+/// \desc font pixels between the text and the edges of the viewport
+static constexpr GLfloat MARGIN = 4.0f;
+
+/// \desc 5x7 glyphs of ASCII 32 to 95, one byte per column from left to right with the top row in bit 0
+static const GLubyte FONT_GLYPHS[NUM_GLYPHS][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00},  // ' '
+    {0x00, 0x00, 0x5F, 0x00, 0x00},  // '!'
+    {0x00, 0x07, 0x00, 0x07, 0x00},  // '"'
+    {0x14, 0x7F, 0x14, 0x7F, 0x14},  // '#'
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12},  // '$'
+    {0x23, 0x13, 0x08, 0x64, 0x62},  // '%'
+    {0x36, 0x49, 0x55, 0x22, 0x50},  // '&'
+    {0x00, 0x05, 0x03, 0x00, 0x00},  // '\''
+    {0x00, 0x1C, 0x22, 0x41, 0x00},  // '('
+    {0x00, 0x41, 0x22, 0x1C, 0x00},  // ')'
+    {0x08, 0x2A, 0x1C, 0x2A, 0x08},  // '*'
+    {0x08, 0x08, 0x3E, 0x08, 0x08},  // '+'
+    {0x00, 0x50, 0x30, 0x00, 0x00},  // ','
+    {0x08, 0x08, 0x08, 0x08, 0x08},  // '-'
+    {0x00, 0x60, 0x60, 0x00, 0x00},  // '.'
+    {0x20, 0x10, 0x08, 0x04, 0x02},  // '/'
+    {0x3E, 0x51, 0x49, 0x45, 0x3E},  // '0'
+    {0x00, 0x42, 0x7F, 0x40, 0x00},  // '1'
+    {0x42, 0x61, 0x51, 0x49, 0x46},  // '2'
+    {0x21, 0x41, 0x45, 0x4B, 0x31},  // '3'
+    {0x18, 0x14, 0x12, 0x7F, 0x10},  // '4'
+    {0x27, 0x45, 0x45, 0x45, 0x39},  // '5'
+    {0x3C, 0x4A, 0x49, 0x49, 0x30},  // '6'
+    {0x01, 0x71, 0x09, 0x05, 0x03},  // '7'
+    {0x36, 0x49, 0x49, 0x49, 0x36},  // '8'
+    {0x06, 0x49, 0x49, 0x29, 0x1E},  // '9'
+    {0x00, 0x36, 0x36, 0x00, 0x00},  // ':'
+    {0x00, 0x56, 0x36, 0x00, 0x00},  // ';'
+    {0x08, 0x14, 0x22, 0x41, 0x00},  // '<'
+    {0x14, 0x14, 0x14, 0x14, 0x14},  // '='
+    {0x00, 0x41, 0x22, 0x14, 0x08},  // '>'
+    {0x02, 0x01, 0x51, 0x09, 0x06},  // '?'
+    {0x32, 0x49, 0x79, 0x41, 0x3E},  // '@'
+    {0x7E, 0x11, 0x11, 0x11, 0x7E},  // 'A'
+    {0x7F, 0x49, 0x49, 0x49, 0x36},  // 'B'
+    {0x3E, 0x41, 0x41, 0x41, 0x22},  // 'C'
+    {0x7F, 0x41, 0x41, 0x22, 0x1C},  // 'D'
+    {0x7F, 0x49, 0x49, 0x49, 0x41},  // 'E'
+    {0x7F, 0x09, 0x09, 0x09, 0x01},  // 'F'
+    {0x3E, 0x41, 0x49, 0x49, 0x7A},  // 'G'
+    {0x7F, 0x08, 0x08, 0x08, 0x7F},  // 'H'
+    {0x00, 0x41, 0x7F, 0x41, 0x00},  // 'I'
+    {0x20, 0x40, 0x41, 0x3F, 0x01},  // 'J'
+    {0x7F, 0x08, 0x14, 0x22, 0x41},  // 'K'
+    {0x7F, 0x40, 0x40, 0x40, 0x40},  // 'L'
+    {0x7F, 0x02, 0x0C, 0x02, 0x7F},  // 'M'
+    {0x7F, 0x04, 0x08, 0x10, 0x7F},  // 'N'
+    {0x3E, 0x41, 0x41, 0x41, 0x3E},  // 'O'
+    {0x7F, 0x09, 0x09, 0x09, 0x06},  // 'P'
+    {0x3E, 0x41, 0x51, 0x21, 0x5E},  // 'Q'
+    {0x7F, 0x09, 0x19, 0x29, 0x46},  // 'R'
+    {0x46, 0x49, 0x49, 0x49, 0x31},  // 'S'
+    {0x01, 0x01, 0x7F, 0x01, 0x01},  // 'T'
+    {0x3F, 0x40, 0x40, 0x40, 0x3F},  // 'U'
+    {0x1F, 0x20, 0x40, 0x20, 0x1F},  // 'V'
+    {0x3F, 0x40, 0x38, 0x40, 0x3F},  // 'W'
+    {0x63, 0x14, 0x08, 0x14, 0x63},  // 'X'
+    {0x07, 0x08, 0x70, 0x08, 0x07},  // 'Y'
+    {0x61, 0x51, 0x49, 0x45, 0x43},  // 'Z'
+    {0x00, 0x7F, 0x41, 0x41, 0x00},  // '['
+    {0x02, 0x04, 0x08, 0x10, 0x20},  // '\\'
+    {0x00, 0x41, 0x41, 0x7F, 0x00},  // ']'
+    {0x04, 0x02, 0x01, 0x02, 0x04},  // '^'
+    {0x40, 0x40, 0x40, 0x40, 0x40},  // '_'
+};
+
+TextOverlay::TextOverlay(const GLfloat scale) {
+    _scale = scale;
+
+    // unpack the glyphs into one row of cells, the texture's first row is the top of the glyphs
+    const GLuint textureWidth = NUM_GLYPHS * CELL_WIDTH;
+    std::vector<GLubyte> texels(textureWidth * CELL_HEIGHT, 0);
+    for(GLuint glyph = 0; glyph < NUM_GLYPHS; glyph++) {
+        for(GLuint column = 0; column < 5; column++) {
+            for(GLuint row = 0; row < 7; row++) {
+                if((FONT_GLYPHS[glyph][column] >> row) & 1) {
+                    texels[row * textureWidth + glyph * CELL_WIDTH + column] = 255;
+                }
+            }
+        }
+    }
+
+    glGenTextures(1, &_fontTexture);
+    glBindTexture(GL_TEXTURE_2D, _fontTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, (GLsizei)textureWidth, CELL_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, texels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    _pShaderProgram = new CSCI441::ShaderProgram("shaders/text.v.glsl", "shaders/text.f.glsl");
+    _uniformLocations.viewportSize = _pShaderProgram->getUniformLocation("viewportSize");
+    _uniformLocations.fontTexture = _pShaderProgram->getUniformLocation("fontTexture");
+    _uniformLocations.textColor = _pShaderProgram->getUniformLocation("textColor");
+    _attributeLocations.vPos = _pShaderProgram->getAttributeLocation("vPos");
+    _attributeLocations.vTexCoord = _pShaderProgram->getAttributeLocation("vTexCoord");
+
+    _pShaderProgram->setProgramUniform(_uniformLocations.fontTexture, 0);
+    _pShaderProgram->setProgramUniform(_uniformLocations.textColor, glm::vec3(1.0f, 1.0f, 0.0f));
+
+    // the buffer and offsets change every draw, only the enabled attributes are kept here
+    glGenVertexArrays(1, &_vao);
+    glBindVertexArray(_vao);
+    glEnableVertexAttribArray(_attributeLocations.vPos);
+    glEnableVertexAttribArray(_attributeLocations.vTexCoord);
+    glBindVertexArray(0);
+}
+
+TextOverlay::~TextOverlay() {
+    glDeleteTextures(1, &_fontTexture);
+    glDeleteVertexArrays(1, &_vao);
+    delete _pShaderProgram;
+}
+
+void TextOverlay::addText(const GLuint column, const GLuint row, const char* text) {
+    const GLfloat cellWidth = (GLfloat)CELL_WIDTH * _scale, cellHeight = (GLfloat)CELL_HEIGHT * _scale;
+    const GLfloat glyphWidth = 5.0f * _scale, glyphHeight = 7.0f * _scale;
+    const GLfloat texelWidth = 1.0f / (GLfloat)(NUM_GLYPHS * CELL_WIDTH);
+
+    GLfloat x = MARGIN * _scale + (GLfloat)column * cellWidth;
+    const GLfloat y = MARGIN * _scale + (GLfloat)row * cellHeight;
+    for(const char* pChar = text; *pChar != '\0'; pChar++, x += cellWidth) {
+        char character = *pChar;
+        if(character >= 'a' && character <= 'z') character = (char)(character - 'a' + 'A');
+        if(character == ' ') continue;
+        if(character < FIRST_GLYPH || character >= FIRST_GLYPH + (char)NUM_GLYPHS) character = '?';
+
+        const GLfloat s0 = (GLfloat)((GLuint)(character - FIRST_GLYPH) * CELL_WIDTH) * texelWidth;
+        const GLfloat s1 = s0 + 5.0f * texelWidth;
+        const GLfloat t1 = 7.0f / (GLfloat)CELL_HEIGHT;
+        const Vertex topLeft = {x, y, s0, 0.0f}, topRight = {x + glyphWidth, y, s1, 0.0f};
+        const Vertex bottomLeft = {x, y + glyphHeight, s0, t1}, bottomRight = {x + glyphWidth, y + glyphHeight, s1, t1};
+        _vertices.insert(_vertices.end(), {topLeft, bottomLeft, topRight, topRight, bottomLeft, bottomRight});
+    }
+}
+
+void TextOverlay::draw(FrameResources& frameResources, const GLint viewportWidth, const GLint viewportHeight) {
+    if(_vertices.empty()) return;
+
+    const GLintptr offset = frameResources.uploadTransient(_vertices.data(), (GLsizeiptr)(_vertices.size() * sizeof(Vertex)), sizeof(Vertex));
+    if(offset < 0) {
+        _vertices.clear();
+        return;
+    }
+
+    _pShaderProgram->useProgram();
+    _pShaderProgram->setProgramUniform(_uniformLocations.viewportSize, glm::vec2((GLfloat)viewportWidth, (GLfloat)viewportHeight));
+
+    countedBindVertexArray(_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, frameResources.getTransientBuffer());
+    glVertexAttribPointer(_attributeLocations.vPos, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offset + offsetof(Vertex, x)));
+    glVertexAttribPointer(_attributeLocations.vTexCoord, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(offset + offsetof(Vertex, s)));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _fontTexture);
+
+    glDisable(GL_DEPTH_TEST);
+    countedDrawArrays(GL_TRIANGLES, 0, (GLsizei)_vertices.size());
+    glEnable(GL_DEPTH_TEST);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+
+    _vertices.clear();
+}
@@ -0,0 +1,72 @@
+#ifndef A3_TEXT_OVERLAY_H
+#define A3_TEXT_OVERLAY_H
+
+#include <GL/glew.h>
+
+#include <CSCI441/ShaderProgram.hpp>
+
+#include "FrameResources.h"
+
+#include <vector>
+
+/// \desc draws lines of text over the finished frame with a built in 5x7 bitmap font.
+///
+/// text is queued with addText() and every queued glyph goes out in a single draw call
+/// from draw(), its vertices streamed through the frame's transient buffer.  the font
+/// covers ASCII 32 to 95, lowercase letters are drawn as uppercase and anything else as '?'.
+class TextOverlay {
+public:
+    /// \desc creates the font texture, shader and vertex array, must be called with a current OpenGL context
+    /// \param scale size of a font pixel in screen pixels
+    explicit TextOverlay(GLfloat scale = 2.0f);
+    ~TextOverlay();
+
+    TextOverlay(const TextOverlay&) = delete;
+    TextOverlay& operator=(const TextOverlay&) = delete;
+
+    /// \desc queues a line of text
+    /// \param column character column the line starts at, from the left edge
+    /// \param row character row of the line, from the top edge
+    /// \param text characters to draw
+    void addText(GLuint column, GLuint row, const char* text);
+
+    /// \desc draws every queued glyph in one draw call and clears the queue
+    /// \param frameResources frame the vertices are streamed through
+    /// \param viewportWidth width of the viewport in pixels
+    /// \param viewportHeight height of the viewport in pixels
+    /// \note draws into whatever framebuffer is bound, without depth testing
+    void draw(FrameResources& frameResources, GLint viewportWidth, GLint viewportHeight);
+
+private:
+    /// \desc a corner of a glyph quad
+    struct Vertex {
+        /// \desc position in pixels from the top left corner of the viewport
+        GLfloat x, y;
+        /// \desc texture coordinate within the font texture
+        GLfloat s, t;
+    };
+
+    /// \desc size of a font pixel in screen pixels
+    GLfloat _scale;
+    /// \desc single channel texture holding every glyph side by side
+    GLuint _fontTexture;
+    /// \desc vertex array pointed at the transient buffer each draw
+    GLuint _vao;
+    /// \desc shader drawing the glyphs in a solid color
+    CSCI441::ShaderProgram* _pShaderProgram;
+    /// \desc uniform locations within the shader
+    struct {
+        GLint viewportSize;
+        GLint fontTexture;
+        GLint textColor;
+    } _uniformLocations;
+    /// \desc attribute locations within the shader
+    struct {
+        GLint vPos;
+        GLint vTexCoord;
+    } _attributeLocations;
+    /// \desc vertices of the queued glyphs
+    std::vector<Vertex> _vertices;
+};
+
+#endif //A3_TEXT_OVERLAY_H
@@ -0,0 +1,289 @@
+/**
+ * @file ProgramPipeline.hpp
+ * @brief Composes separable Shader Programs into a Program Pipeline
+ * @author Taylor Rodgers
+ *
+ * @copyright MIT License Copyright (c) 2026 Taylor Rodgers
+ *
+ *	Separable Shader Programs are bound stage by stage into Program Pipelines,
+ *	one pipeline is kept per set of stage programs, and uniforms are set by name
+ *	on whichever stage program declares them.
+ *
+ *	@warning NOTE: This header file depends upon glm
+ */
+
+#ifndef CSCI441_PROGRAM_PIPELINE_HPP
+#define CSCI441_PROGRAM_PIPELINE_HPP
+
+#include "ShaderProgram.hpp"
+#include "ShaderUtils.hpp"
+
+#include <array>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441 {
+
+    /**
+     * @class ProgramPipeline
+     * @brief Binds the stages of several separable Shader Programs together so a stage can be
+     * swapped without linking a new program.  Uniforms are set by name and go to whichever stage
+     * program declares them.
+     * @note the pipeline does not own its stage programs, they must outlive it
+     */
+    class ProgramPipeline final {
+    public:
+        /**
+         * @brief number of shader stages a pipeline can hold
+         */
+        static constexpr size_t NUM_STAGES = 5;
+        /**
+         * @brief stage bits in the order a pipeline stores its programs
+         */
+        static constexpr std::array<GLbitfield, NUM_STAGES> STAGE_BITS = {
+            GL_VERTEX_SHADER_BIT, GL_TESS_CONTROL_SHADER_BIT, GL_TESS_EVALUATION_SHADER_BIT,
+            GL_GEOMETRY_SHADER_BIT, GL_FRAGMENT_SHADER_BIT
+        };
+
+        /**
+         * @brief Creates an empty Program Pipeline
+         */
+        ProgramPipeline();
+        /**
+         * @brief Deletes the Program Pipeline
+         */
+        ~ProgramPipeline();
+
+        /**
+         * @brief do not allow pipelines to be copied
+         */
+        ProgramPipeline(const ProgramPipeline&) = delete;
+        /**
+         * @brief do not allow pipelines to be copied
+         */
+        ProgramPipeline& operator=(const ProgramPipeline&) = delete;
+
+        /**
+         * @brief uses stages of a separable Shader Program in this pipeline
+         * @param pShaderProgram separable program to take the stages from
+         * @param stages bitfield of the stages to take, only those the program has are used
+         * @return true if any stage was taken from the program, false otherwise
+         */
+        bool useProgramStages( const ShaderProgram *pShaderProgram, GLbitfield stages = GL_ALL_SHADER_BITS );
+        /**
+         * @brief binds this pipeline as the current one
+         * @note unbinds any Shader Program made current with ShaderProgram::useProgram()
+         */
+        void bindPipeline() const;
+        /**
+         * @brief validates the pipeline against the current OpenGL state and prints the log if it fails
+         * @return true if the pipeline can be drawn with, false otherwise
+         */
+        [[nodiscard]] bool validate() const;
+
+        /**
+         * @brief returns the handle for this Program Pipeline
+         */
+        [[nodiscard]] GLuint getProgramPipelineHandle() const noexcept { return mProgramPipelineHandle; }
+        /**
+         * @brief returns the Shader Program used for a stage
+         * @param stage single stage bit, such as GL_VERTEX_SHADER_BIT
+         * @return the Shader Program or nullptr if the stage is not used
+         */
+        [[nodiscard]] const ShaderProgram* getStageProgram( GLbitfield stage ) const;
+
+        /**
+         * @brief sets a uniform on every stage program that declares it
+         * @param uniformName name of the uniform
+         * @param args values to set, as accepted by ShaderProgram::setProgramUniform()
+         * @note prints an error if no stage program declares the uniform
+         */
+        template<typename... Args>
+        void setProgramUniform( const char *uniformName, Args... args ) const;
+
+    private:
+        GLuint mProgramPipelineHandle;
+        std::array<const ShaderProgram*, NUM_STAGES> mpStagePrograms;
+    };
+
+    /**
+     * @class ProgramPipelineCache
+     * @brief Hands out Program Pipelines by the set of stage programs they are made of, so each
+     * combination is only set up once
+     * @note the cache does not own the stage programs, clear it before deleting any of them
+     */
+    class ProgramPipelineCache final {
+    public:
+        ProgramPipelineCache() = default;
+        /**
+         * @brief Deletes every Program Pipeline
+         */
+        ~ProgramPipelineCache();
+
+        /**
+         * @brief do not allow caches to be copied
+         */
+        ProgramPipelineCache(const ProgramPipelineCache&) = delete;
+        /**
+         * @brief do not allow caches to be copied
+         */
+        ProgramPipelineCache& operator=(const ProgramPipelineCache&) = delete;
+
+        /**
+         * @brief returns the pipeline made of a set of separable Shader Programs, creating it the first time it is asked for
+         * @param shaderPrograms programs to use every stage of, a later program takes a stage over from an earlier one
+         * @returns the pipeline, owned by the cache
+         */
+        [[nodiscard]] ProgramPipeline* getPipeline( const std::vector<const ShaderProgram*>& shaderPrograms );
+        /**
+         * @brief number of pipelines created so far
+         */
+        [[nodiscard]] size_t getNumPipelines() const noexcept { return mPipelines.size(); }
+
+        /**
+         * @brief deletes every Program Pipeline
+         * @note any Program Pipeline handed out before is no longer valid
+         */
+        void clear();
+
+    private:
+        /**
+         * @brief program handle used for each stage, 0 if the stage is unused
+         */
+        using StageSet = std::array<GLuint, ProgramPipeline::NUM_STAGES>;
+
+        std::map<StageSet, ProgramPipeline*> mPipelines;
+    };
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+inline CSCI441::ProgramPipeline::ProgramPipeline() : mProgramPipelineHandle(0), mpStagePrograms{} {
+    glGenProgramPipelines(1, &mProgramPipelineHandle);
+}
+
+inline CSCI441::ProgramPipeline::~ProgramPipeline() {
+    glDeleteProgramPipelines(1, &mProgramPipelineHandle);
+}
+
+inline bool CSCI441::ProgramPipeline::useProgramStages( const ShaderProgram *pShaderProgram, const GLbitfield stages ) {
+    if( pShaderProgram == nullptr ) {
+        glUseProgramStages(mProgramPipelineHandle, stages, 0);
+        for(size_t i = 0; i < NUM_STAGES; i++) {
+            if( stages & STAGE_BITS[i] ) mpStagePrograms[i] = nullptr;
+        }
+        return false;
+    }
+
+    GLint isSeparable = GL_FALSE;
+    glGetProgramiv(pShaderProgram->getShaderProgramHandle(), GL_PROGRAM_SEPARABLE, &isSeparable);
+    if( isSeparable != GL_TRUE ) {
+        fprintf(stderr, "[ERROR]: Shader Program %u is not separable and cannot be used in a Program Pipeline\n", pShaderProgram->getShaderProgramHandle());
+        return false;
+    }
+
+    const GLbitfield programStages = stages & pShaderProgram->getProgramStages();
+    if( programStages == 0 ) return false;
+
+    glUseProgramStages(mProgramPipelineHandle, programStages, pShaderProgram->getShaderProgramHandle());
+    for(size_t i = 0; i < NUM_STAGES; i++) {
+        if( programStages & STAGE_BITS[i] ) mpStagePrograms[i] = pShaderProgram;
+    }
+    return true;
+}
+
+inline void CSCI441::ProgramPipeline::bindPipeline() const {
+    // a program made current with glUseProgram takes precedence over the bound pipeline
+    glUseProgram(0);
+    glBindProgramPipeline(mProgramPipelineHandle);
+    if( ShaderProgram::sUseProgramCallback != nullptr ) ShaderProgram::sUseProgramCallback();
+}
+
+inline bool CSCI441::ProgramPipeline::validate() const {
+    glValidateProgramPipeline(mProgramPipelineHandle);
+    GLint status = GL_FALSE;
+    glGetProgramPipelineiv(mProgramPipelineHandle, GL_VALIDATE_STATUS, &status);
+    if( status != GL_TRUE ) {
+        CSCI441_INTERNAL::ShaderUtils::printProgramPipelineLog(mProgramPipelineHandle);
+        return false;
+    }
+    return true;
+}
+
+inline const CSCI441::ShaderProgram* CSCI441::ProgramPipeline::getStageProgram( const GLbitfield stage ) const {
+    for(size_t i = 0; i < NUM_STAGES; i++) {
+        if( stage == STAGE_BITS[i] ) return mpStagePrograms[i];
+    }
+    return nullptr;
+}
+
+template<typename... Args>
+inline void CSCI441::ProgramPipeline::setProgramUniform( const char *uniformName, Args... args ) const {
+    bool isFound = false;
+    for(size_t i = 0; i < NUM_STAGES; i++) {
+        const ShaderProgram *pStageProgram = mpStagePrograms[i];
+        if( pStageProgram == nullptr || !pStageProgram->hasUniform(uniformName) ) continue;
+
+        // a program holding several stages only needs the value once
+        bool isSetAlready = false;
+        for(size_t j = 0; j < i; j++) {
+            if( mpStagePrograms[j] == pStageProgram ) { isSetAlready = true; break; }
+        }
+        if( isSetAlready ) continue;
+
+        pStageProgram->setProgramUniform(uniformName, args...);
+        isFound = true;
+    }
+    if( !isFound ) {
+        fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" in any stage of Program Pipeline %u\n", uniformName, mProgramPipelineHandle);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+inline CSCI441::ProgramPipelineCache::~ProgramPipelineCache() {
+    clear();
+}
+
+inline CSCI441::ProgramPipeline* CSCI441::ProgramPipelineCache::getPipeline( const std::vector<const ShaderProgram*>& shaderPrograms ) {
+    StageSet stageSet{};
+    for(const ShaderProgram *pShaderProgram : shaderPrograms) {
+        if( pShaderProgram == nullptr ) continue;
+        const GLbitfield programStages = pShaderProgram->getProgramStages();
+        for(size_t i = 0; i < ProgramPipeline::NUM_STAGES; i++) {
+            if( programStages & ProgramPipeline::STAGE_BITS[i] ) stageSet[i] = pShaderProgram->getShaderProgramHandle();
+        }
+    }
+
+    const auto pipelineIter = mPipelines.find(stageSet);
+    if( pipelineIter != mPipelines.end() ) {
+        return pipelineIter->second;
+    }
+
+    CSCI441_TRACE_SCOPE("ProgramPipelineCache::createPipeline");
+    auto pPipeline = new ProgramPipeline();
+    for(const ShaderProgram *pShaderProgram : shaderPrograms) {
+        if( pShaderProgram == nullptr ) continue;
+        // only the stages this program still holds in the set, later programs win
+        GLbitfield stages = 0;
+        for(size_t i = 0; i < ProgramPipeline::NUM_STAGES; i++) {
+            if( stageSet[i] == pShaderProgram->getShaderProgramHandle() ) stages |= ProgramPipeline::STAGE_BITS[i];
+        }
+        if( stages != 0 ) pPipeline->useProgramStages(pShaderProgram, stages);
+    }
+    mPipelines.emplace(stageSet, pPipeline);
+    return pPipeline;
+}
+
+inline void CSCI441::ProgramPipelineCache::clear() {
+    for(auto& pipeline : mPipelines) {
+        delete pipeline.second;
+    }
+    mPipelines.clear();
+}
+
+#endif // CSCI441_PROGRAM_PIPELINE_HPP
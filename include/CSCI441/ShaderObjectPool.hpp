@@ -0,0 +1,235 @@
+/**
+ * @file ShaderObjectPool.hpp
+ * @brief Shares compiled shader objects between Shader Programs
+ * @author Taylor Rodgers
+ *
+ * @copyright MIT License Copyright (c) 2026 Taylor Rodgers
+ *
+ *	Compiled shader objects are kept after linking, keyed by stage and a hash of
+ *	their preprocessed source, so programs sharing a stage compile it once.  Unused
+ *	objects are kept up to a budget or until the pool is flushed.
+ *
+ *	@warning NOTE: This header file depends upon GLEW
+ */
+
+#ifndef CSCI441_SHADER_OBJECT_POOL_HPP
+#define CSCI441_SHADER_OBJECT_POOL_HPP
+
+#include "ShaderSourceCache.hpp"
+#include "ShaderUtils.hpp"
+#include "trace.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441 {
+
+    /**
+     * @class ShaderObjectPool
+     * @brief Keeps compiled shader objects alive after linking so a stage shared by several
+     * programs is only compiled once.  Shader objects are told apart by their stage and a hash of
+     * their preprocessed source, so a changed file or different defines compile a new one.
+     * @note every context that acquires from the pool must share objects with the others
+     */
+    class ShaderObjectPool final {
+    public:
+        /**
+         * @brief returns a compiled shader object for a file, compiling it only if no program compiled the same source before
+         * @param filename name of the shader file to load
+         * @param shaderType type of shader the file corresponds to
+         * @param defines macros to define after the #version line, each as "NAME" or "NAME VALUE"
+         * @returns shader handle, -1 if the file could not be read
+         * @note hand the shader object back with release() once the program is linked
+         */
+        static GLuint acquire(const char* filename, GLenum shaderType, const std::vector<std::string>& defines = {});
+        /**
+         * @brief hands back a shader object from acquire(), it is kept for reuse while within the budget
+         * @param shaderHandle shader handle to release
+         */
+        static void release(GLuint shaderHandle);
+
+        /**
+         * @brief sets how many shader objects no program is using are kept for reuse, the least recently used are deleted first
+         * @param maxIdleShaders most unused shader objects to keep, 0 deletes each one when it is released
+         */
+        [[maybe_unused]] static void setBudget(size_t maxIdleShaders);
+        /**
+         * @brief deletes every shader object no program is using
+         * @note must be called while a context that shares objects with the pool is current
+         */
+        [[maybe_unused]] static void flush();
+
+        /**
+         * @brief number of shader objects in the pool
+         */
+        [[maybe_unused]] [[nodiscard]] static size_t getNumShaderObjects();
+        /**
+         * @brief number of times a compiled shader object was reused instead of compiling the source again
+         */
+        [[maybe_unused]] [[nodiscard]] static size_t getNumReuses();
+
+    private:
+        /**
+         * @brief stage and source hash a shader object was compiled from
+         */
+        using Key = std::pair<GLenum, uint64_t>;
+        /**
+         * @brief a pooled shader object
+         */
+        struct Entry {
+            GLuint shaderHandle;
+            // number of acquires not yet released
+            GLuint numUsers;
+            // value of sUseCounter when last acquired
+            uint64_t lastUse;
+        };
+
+        static std::mutex sMutex;
+        static std::map<Key, Entry> sShaders;
+        static size_t sBudget;
+        static uint64_t sUseCounter;
+        static size_t sNumReuses;
+
+        static uint64_t _hashSource(const ShaderSource& shaderSource);
+        // deletes the least recently used idle shader objects until the budget is met, sMutex must be held
+        static void _trim(size_t maxIdleShaders);
+    };
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+inline std::mutex CSCI441::ShaderObjectPool::sMutex;
+inline std::map<CSCI441::ShaderObjectPool::Key, CSCI441::ShaderObjectPool::Entry> CSCI441::ShaderObjectPool::sShaders;
+inline size_t CSCI441::ShaderObjectPool::sBudget = 64;
+inline uint64_t CSCI441::ShaderObjectPool::sUseCounter = 0;
+inline size_t CSCI441::ShaderObjectPool::sNumReuses = 0;
+
+inline GLuint CSCI441::ShaderObjectPool::acquire(
+        const char* filename,
+        const GLenum shaderType,
+        const std::vector<std::string>& defines
+) {
+    const auto pShaderSource = ShaderSourceCache::load( filename, defines );
+    if( pShaderSource == nullptr ) {
+        return -1;
+    }
+    const Key key( shaderType, _hashSource(*pShaderSource) );
+
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        auto shaderIter = sShaders.find(key);
+        if( shaderIter != sShaders.end() ) {
+            shaderIter->second.numUsers++;
+            shaderIter->second.lastUse = ++sUseCounter;
+            sNumReuses++;
+            return shaderIter->second.shaderHandle;
+        }
+    }
+
+    // compile without holding the lock, another context may be compiling at the same time
+    GLuint shaderHandle;
+    {
+        CSCI441_TRACE_SCOPE("ShaderObjectPool::compile");
+        shaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader( *pShaderSource, shaderType );
+    }
+
+    // a shader that failed to compile is not kept, so its errors are printed every time
+    GLint compileStatus = GL_FALSE;
+    glGetShaderiv( shaderHandle, GL_COMPILE_STATUS, &compileStatus );
+    if( compileStatus != GL_TRUE ) {
+        return shaderHandle;
+    }
+
+    std::lock_guard<std::mutex> lock(sMutex);
+    auto insertResult = sShaders.emplace(key, Entry{shaderHandle, 0, 0});
+    if( !insertResult.second ) {
+        // the same source was compiled elsewhere in the meantime, use that one
+        glDeleteShader( shaderHandle );
+    }
+    Entry& entry = insertResult.first->second;
+    entry.numUsers++;
+    entry.lastUse = ++sUseCounter;
+    return entry.shaderHandle;
+}
+
+inline void CSCI441::ShaderObjectPool::release(const GLuint shaderHandle) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    for(auto& shader : sShaders) {
+        if( shader.second.shaderHandle == shaderHandle ) {
+            if( shader.second.numUsers > 0 ) shader.second.numUsers--;
+            _trim(sBudget);
+            return;
+        }
+    }
+    // never pooled, as when it failed to compile
+    glDeleteShader( shaderHandle );
+}
+
+[[maybe_unused]]
+inline void CSCI441::ShaderObjectPool::setBudget(const size_t maxIdleShaders) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sBudget = maxIdleShaders;
+    _trim(sBudget);
+}
+
+[[maybe_unused]]
+inline void CSCI441::ShaderObjectPool::flush() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    _trim(0);
+}
+
+[[maybe_unused]]
+inline size_t CSCI441::ShaderObjectPool::getNumShaderObjects() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    return sShaders.size();
+}
+
+[[maybe_unused]]
+inline size_t CSCI441::ShaderObjectPool::getNumReuses() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    return sNumReuses;
+}
+
+inline uint64_t CSCI441::ShaderObjectPool::_hashSource(const ShaderSource& shaderSource) {
+    // FNV-1a over the pieces in order, the same source split differently hashes the same
+    uint64_t hash = 14695981039346656037ull;
+    for(GLsizei i = 0; i < shaderSource.getNumStrings(); i++) {
+        const GLchar* string = shaderSource.getStrings()[i];
+        const GLint length = shaderSource.getLengths()[i];
+        for(GLint j = 0; j < length; j++) {
+            hash ^= (unsigned char)string[j];
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+inline void CSCI441::ShaderObjectPool::_trim(const size_t maxIdleShaders) {
+    size_t numIdle = 0;
+    for(const auto& shader : sShaders) {
+        if( shader.second.numUsers == 0 ) numIdle++;
+    }
+
+    while( numIdle > maxIdleShaders ) {
+        auto oldestIter = sShaders.end();
+        for(auto shaderIter = sShaders.begin(); shaderIter != sShaders.end(); ++shaderIter) {
+            if( shaderIter->second.numUsers != 0 ) continue;
+            if( oldestIter == sShaders.end() || shaderIter->second.lastUse < oldestIter->second.lastUse ) {
+                oldestIter = shaderIter;
+            }
+        }
+        glDeleteShader( oldestIter->second.shaderHandle );
+        sShaders.erase(oldestIter);
+        numIdle--;
+    }
+}
+
+#endif // CSCI441_SHADER_OBJECT_POOL_HPP
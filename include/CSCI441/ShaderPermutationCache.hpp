@@ -0,0 +1,182 @@
+/**
+ * @file ShaderPermutationCache.hpp
+ * @brief Compiles specialised variants of a Shader Program on demand
+ * @author Taylor Rodgers
+ *
+ * @copyright MIT License Copyright (c) 2026 Taylor Rodgers
+ *
+ *	Each feature of a shader pair is a macro, a variant is compiled with the
+ *	macros of its features the first time it is asked for and kept by feature mask.
+ *
+ *	@warning NOTE: This header file depends upon glm
+ */
+
+#ifndef CSCI441_SHADER_PERMUTATION_CACHE_HPP
+#define CSCI441_SHADER_PERMUTATION_CACHE_HPP
+
+#include "ShaderProgram.hpp"
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace CSCI441 {
+
+    /**
+     * @class ShaderPermutationCache
+     * @brief Hands out variants of one vertex and fragment shader pair, each specialised by a
+     * set of features.  Every feature is a macro defined in the shaders when its bit is set, a
+     * variant is compiled the first time it is asked for and kept until the cache is cleared.
+     * @note Shader Programs must be created on the thread that owns the OpenGL context, so the
+     * cache is not safe to use from any other thread.
+     */
+    class ShaderPermutationCache final {
+    public:
+        /**
+         * @brief set of features, bit i selects the i-th feature define
+         */
+        using FeatureMask = GLuint64;
+        /**
+         * @brief most features a cache can tell apart
+         */
+        static constexpr size_t MAX_FEATURES = 64;
+
+        /**
+         * @brief Creates an empty cache, no shader is compiled until a variant is asked for
+         * @param vertexShaderFilename name of the file corresponding to the vertex shader
+         * @param fragmentShaderFilename name of the file corresponding to the fragment shader
+         * @param featureDefines macro defined for each feature, each as "NAME" or "NAME VALUE", in bit order
+         * @param isSeparable if the variants are separable programs
+         */
+        ShaderPermutationCache( const char *vertexShaderFilename,
+                                const char *fragmentShaderFilename,
+                                std::vector<std::string> featureDefines,
+                                bool isSeparable = false );
+        /**
+         * @brief Deletes every compiled variant
+         */
+        ~ShaderPermutationCache();
+
+        /**
+         * @brief do not allow caches to be copied
+         */
+        ShaderPermutationCache(const ShaderPermutationCache&) = delete;
+        /**
+         * @brief do not allow caches to be copied
+         */
+        ShaderPermutationCache& operator=(const ShaderPermutationCache&) = delete;
+
+        /**
+         * @brief returns the variant with a set of features, compiling it if this is the first time it is asked for
+         * @param features bitmask of the features to enable
+         * @returns the variant, owned by the cache
+         */
+        [[nodiscard]] ShaderProgram* getProgram(FeatureMask features);
+        /**
+         * @brief puts a program in place of a variant, such as one recompiled after its source changed
+         * @param features bitmask of the features of the variant
+         * @param pProgram program compiled with the defines of the features, the cache takes ownership of it
+         * @note the variant's previous program is deleted
+         */
+        void replaceProgram(FeatureMask features, ShaderProgram* pProgram);
+        /**
+         * @brief the macros a set of features defines
+         * @param features bitmask of the features
+         */
+        [[nodiscard]] std::vector<std::string> getDefines(FeatureMask features) const;
+        /**
+         * @brief number of features the cache was created with
+         */
+        [[nodiscard]] size_t getNumFeatures() const noexcept { return mFeatureDefines.size(); }
+        /**
+         * @brief number of variants compiled so far
+         */
+        [[nodiscard]] size_t getNumVariants() const noexcept { return mVariants.size(); }
+
+        /**
+         * @brief deletes every compiled variant, they are compiled again when next asked for
+         * @note any Shader Program handed out before is no longer valid
+         */
+        void clear();
+
+    private:
+        /**
+         * @brief drops the bits past the last feature, they select nothing so must not make another variant
+         */
+        [[nodiscard]] FeatureMask _maskFeatures(FeatureMask features) const noexcept;
+
+        std::string mVertexShaderFilename;
+        std::string mFragmentShaderFilename;
+        std::vector<std::string> mFeatureDefines;
+        bool mIsSeparable;
+        std::unordered_map<FeatureMask, ShaderProgram*> mVariants;
+    };
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+inline CSCI441::ShaderPermutationCache::ShaderPermutationCache(
+        const char *vertexShaderFilename,
+        const char *fragmentShaderFilename,
+        std::vector<std::string> featureDefines,
+        const bool isSeparable
+) : mVertexShaderFilename(vertexShaderFilename),
+    mFragmentShaderFilename(fragmentShaderFilename),
+    mFeatureDefines(std::move(featureDefines)),
+    mIsSeparable(isSeparable) {
+    if( mFeatureDefines.size() > MAX_FEATURES ) {
+        fprintf(stderr, "[ERROR]: A shader permutation cache supports %zu features, %zu were given\n", MAX_FEATURES, mFeatureDefines.size());
+        mFeatureDefines.resize(MAX_FEATURES);
+    }
+}
+
+inline CSCI441::ShaderPermutationCache::~ShaderPermutationCache() {
+    clear();
+}
+
+inline CSCI441::ShaderProgram* CSCI441::ShaderPermutationCache::getProgram(FeatureMask features) {
+    features = _maskFeatures(features);
+
+    const auto variantIter = mVariants.find(features);
+    if( variantIter != mVariants.end() ) {
+        return variantIter->second;
+    }
+
+    CSCI441_TRACE_SCOPE("ShaderPermutationCache::compileVariant");
+    auto pProgram = new ShaderProgram(mVertexShaderFilename.c_str(), mFragmentShaderFilename.c_str(), getDefines(features), mIsSeparable);
+    mVariants.emplace(features, pProgram);
+    return pProgram;
+}
+
+inline void CSCI441::ShaderPermutationCache::replaceProgram(const FeatureMask features, ShaderProgram* pProgram) {
+    ShaderProgram*& pVariant = mVariants[_maskFeatures(features)];
+    if( pVariant != pProgram ) delete pVariant;
+    pVariant = pProgram;
+}
+
+inline std::vector<std::string> CSCI441::ShaderPermutationCache::getDefines(const FeatureMask features) const {
+    std::vector<std::string> defines;
+    for(size_t i = 0; i < mFeatureDefines.size(); i++) {
+        if( features & ((FeatureMask)1 << i) ) defines.push_back(mFeatureDefines[i]);
+    }
+    return defines;
+}
+
+inline CSCI441::ShaderPermutationCache::FeatureMask CSCI441::ShaderPermutationCache::_maskFeatures(const FeatureMask features) const noexcept {
+    if( mFeatureDefines.size() >= MAX_FEATURES ) return features;
+    return features & (((FeatureMask)1 << mFeatureDefines.size()) - 1);
+}
+
+inline void CSCI441::ShaderPermutationCache::clear() {
+    for(auto& variant : mVariants) {
+        delete variant.second;
+    }
+    mVariants.clear();
+}
+
+#endif // CSCI441_SHADER_PERMUTATION_CACHE_HPP
@@ -13,6 +13,7 @@
 #ifndef CSCI441_SHADER_PROGRAM_HPP
 #define CSCI441_SHADER_PROGRAM_HPP
 
+#include "ShaderObjectPool.hpp"
 #include "ShaderUtils.hpp"
 
 #include <glm/glm.hpp>
@@ -44,6 +45,28 @@ namespace CSCI441 {
          */
         [[maybe_unused]] static void disableDebugMessages();
 
+        /**
+         * @brief hook called after every uniform upload made through a Shader Program
+         * @param numBytes size of the uploaded values in bytes
+         */
+        using UniformUploadCallback = void(*)(GLsizeiptr numBytes);
+        /**
+         * @brief hook called every time a Shader Program is made current
+         */
+        using UseProgramCallback = void(*)();
+        /**
+         * @brief sets the hook called after every uniform upload, for gathering render statistics
+         * @param callback function to call, nullptr to disable
+         * @note the hook is shared by every Shader Program and defaults to none
+         */
+        [[maybe_unused]] static void setUniformUploadCallback(UniformUploadCallback callback);
+        /**
+         * @brief sets the hook called every time a Shader Program is made current, for gathering render statistics
+         * @param callback function to call, nullptr to disable
+         * @note the hook is shared by every Shader Program and defaults to none
+         */
+        [[maybe_unused]] static void setUseProgramCallback(UseProgramCallback callback);
+
         /**
          * @brief Creates a Shader Program using a Vertex Shader and Fragment Shader
          * @param vertexShaderFilename name of the file corresponding to the vertex shader
@@ -160,6 +183,19 @@ namespace CSCI441 {
                        bool vertexPresent, bool tessellationPresent, bool geometryPresent, bool fragmentPresent,
                        bool isSeparable );
 
+        /**
+         * @brief Creates a Shader Program using a Vertex Shader and Fragment Shader specialised by a set of macros
+         * @param vertexShaderFilename name of the file corresponding to the vertex shader
+         * @param fragmentShaderFilename name of the file corresponding to the fragment shader
+         * @param defines macros defined after the #version line of each shader, each as "NAME" or "NAME VALUE"
+         * @param isSeparable if program is separable
+         */
+        [[maybe_unused]]
+        ShaderProgram( const char *vertexShaderFilename,
+                       const char *fragmentShaderFilename,
+                       const std::vector<std::string>& defines,
+                       bool isSeparable = false );
+
         /**
          * @brief Clean up memory associated with the Shader Program
          */
@@ -197,6 +233,14 @@ namespace CSCI441 {
          */
         virtual GLint getUniformLocation( const char *uniformName ) const final;
 
+        /**
+         * @brief Returns whether the given uniform is active in this shader program
+         * @param uniformName name of the uniform to look for
+         * @return true if the uniform can be set on this shader program
+         * @note Unlike getUniformLocation(), prints nothing if the uniform is not found
+         */
+        [[nodiscard]] virtual bool hasUniform( const char *uniformName ) const final;
+
         /**
          * @brief Returns the index of the given uniform block in this shader program
          * @param uniformBlockName name of the uniform block to get the index for
@@ -852,6 +896,11 @@ namespace CSCI441 {
          */
         std::map<std::string, GLint> *mpAttributeLocationsMap;
 
+        /**
+         * @brief macros defined in every stage the program is compiled from
+         */
+        std::vector<std::string> mDefines;
+
         /**
          * @brief registers a shader program with the GPU
          * @param vertexShaderFilename vertex shader filename to load from text file
@@ -870,7 +919,23 @@ namespace CSCI441 {
                                             bool isSeparable ) final;
 
     private:
+        friend class ProgramPipeline;
+
         void _initialize();
+
+        /**
+         * @brief hook called after every uniform upload
+         */
+        static UniformUploadCallback sUniformUploadCallback;
+        /**
+         * @brief hook called every time a Shader Program is made current
+         */
+        static UseProgramCallback sUseProgramCallback;
+        /**
+         * @brief passes the size of an upload to the uniform upload hook if one is set
+         * @param numBytes size of the uploaded values in bytes
+         */
+        static void _countUniformUpload(GLsizeiptr numBytes);
     };
 
 }
@@ -878,6 +943,8 @@ namespace CSCI441 {
 ////////////////////////////////////////////////////////////////////////////////
 
 inline bool CSCI441::ShaderProgram::sDEBUG = true;
+inline CSCI441::ShaderProgram::UniformUploadCallback CSCI441::ShaderProgram::sUniformUploadCallback = nullptr;
+inline CSCI441::ShaderProgram::UseProgramCallback CSCI441::ShaderProgram::sUseProgramCallback = nullptr;
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::enableDebugMessages() {
@@ -889,6 +956,20 @@ inline void CSCI441::ShaderProgram::disableDebugMessages() {
     sDEBUG = false;
 }
 
+[[maybe_unused]]
+inline void CSCI441::ShaderProgram::setUniformUploadCallback(UniformUploadCallback callback) {
+    sUniformUploadCallback = callback;
+}
+
+[[maybe_unused]]
+inline void CSCI441::ShaderProgram::setUseProgramCallback(UseProgramCallback callback) {
+    sUseProgramCallback = callback;
+}
+
+inline void CSCI441::ShaderProgram::_countUniformUpload(const GLsizeiptr numBytes) {
+    if( sUniformUploadCallback != nullptr ) sUniformUploadCallback( numBytes );
+}
+
 inline CSCI441::ShaderProgram::ShaderProgram( const char *vertexShaderFilename, const char *fragmentShaderFilename ) {
     _initialize();
     mRegisterShaderProgram(vertexShaderFilename, "", "", "", fragmentShaderFilename, false);
@@ -1029,17 +1110,29 @@ inline CSCI441::ShaderProgram::ShaderProgram( const char **shaderFilenames,
     }
 }
 
+[[maybe_unused]]
+inline CSCI441::ShaderProgram::ShaderProgram( const char *vertexShaderFilename, const char *fragmentShaderFilename, const std::vector<std::string>& defines, const bool isSeparable ) {
+    _initialize();
+    mDefines = defines;
+    mRegisterShaderProgram(vertexShaderFilename, "", "", "", fragmentShaderFilename, isSeparable);
+}
+
 inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexShaderFilename, const char *tessellationControlShaderFilename, const char *tessellationEvaluationShaderFilename, const char *geometryShaderFilename, const char *fragmentShaderFilename, const bool isSeparable ) {
+    CSCI441_TRACE_SCOPE("ShaderProgram::mRegisterShaderProgram");
+
     GLint major, minor;
     glGetIntegerv(GL_MAJOR_VERSION, &major);
     glGetIntegerv(GL_MINOR_VERSION, &minor);
 
     if( sDEBUG ) printf( "\n[INFO]: /--------------------------------------------------------\\\n");
+    if( sDEBUG ) {
+        for( const std::string& define : mDefines ) printf( "[INFO]: | Define: %46s |\n", define.c_str() );
+    }
 
     /* compile each one of our shaders */
     if( strcmp( vertexShaderFilename, "" ) != 0 ) {
         if( sDEBUG ) printf( "[INFO]: | Vertex Shader: %39s |\n", vertexShaderFilename );
-        mVertexShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(vertexShaderFilename, GL_VERTEX_SHADER );
+        mVertexShaderHandle = CSCI441::ShaderObjectPool::acquire(vertexShaderFilename, GL_VERTEX_SHADER, mDefines );
     } else {
         mVertexShaderHandle = 0;
     }
@@ -1050,7 +1143,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
             printf( "[ERROR]:|   TESSELLATION SHADER NOT SUPPORTED!! UPGRADE TO v4.0+ |\n" );
             mTessellationControlShaderHandle = 0;
         } else {
-            mTessellationControlShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(tessellationControlShaderFilename, GL_TESS_CONTROL_SHADER );
+            mTessellationControlShaderHandle = CSCI441::ShaderObjectPool::acquire(tessellationControlShaderFilename, GL_TESS_CONTROL_SHADER, mDefines );
         }
     } else {
         mTessellationControlShaderHandle = 0;
@@ -1062,7 +1155,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
             printf( "[ERROR]:|   TESSELLATION SHADER NOT SUPPORTED!! UPGRADE TO v4.0+ |\n" );
             mTessellationEvaluationShaderHandle = 0;
         } else {
-            mTessellationEvaluationShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(tessellationEvaluationShaderFilename, GL_TESS_EVALUATION_SHADER );
+            mTessellationEvaluationShaderHandle = CSCI441::ShaderObjectPool::acquire(tessellationEvaluationShaderFilename, GL_TESS_EVALUATION_SHADER, mDefines );
         }
     } else {
         mTessellationEvaluationShaderHandle = 0;
@@ -1074,7 +1167,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
             printf( "[ERROR]:|   GEOMETRY SHADER NOT SUPPORTED!!!    UPGRADE TO v3.2+ |\n" );
             mGeometryShaderHandle = 0;
         } else {
-            mGeometryShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(geometryShaderFilename, GL_GEOMETRY_SHADER );
+            mGeometryShaderHandle = CSCI441::ShaderObjectPool::acquire(geometryShaderFilename, GL_GEOMETRY_SHADER, mDefines );
         }
     } else {
         mGeometryShaderHandle = 0;
@@ -1082,7 +1175,7 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
 
     if( strcmp( fragmentShaderFilename, "" ) != 0 ) {
         if( sDEBUG ) printf( "[INFO]: | Fragment Shader: %37s |\n", fragmentShaderFilename );
-        mFragmentShaderHandle = CSCI441_INTERNAL::ShaderUtils::compileShader(fragmentShaderFilename, GL_FRAGMENT_SHADER );
+        mFragmentShaderHandle = CSCI441::ShaderObjectPool::acquire(fragmentShaderFilename, GL_FRAGMENT_SHADER, mDefines );
     } else {
         mFragmentShaderHandle = 0;
     }
@@ -1119,26 +1212,26 @@ inline bool CSCI441::ShaderProgram::mRegisterShaderProgram(const char *vertexSha
     /* check the program log */
     CSCI441_INTERNAL::ShaderUtils::printProgramLog(mShaderProgramHandle );
 
-    /* detach & delete the vertex and fragment shaders to the shader program */
+    /* detach the shaders and hand them back to the pool, which keeps them for other programs */
     if(mVertexShaderHandle != 0 ) {
         glDetachShader(mShaderProgramHandle, mVertexShaderHandle );
-        glDeleteShader(mVertexShaderHandle );
+        CSCI441::ShaderObjectPool::release(mVertexShaderHandle );
     }
     if(mTessellationControlShaderHandle != 0 ) {
         glDetachShader(mShaderProgramHandle, mTessellationControlShaderHandle );
-        glDeleteShader(mTessellationControlShaderHandle );
+        CSCI441::ShaderObjectPool::release(mTessellationControlShaderHandle );
     }
     if(mTessellationEvaluationShaderHandle != 0 ) {
         glDetachShader(mShaderProgramHandle, mTessellationEvaluationShaderHandle );
-        glDeleteShader(mTessellationEvaluationShaderHandle );
+        CSCI441::ShaderObjectPool::release(mTessellationEvaluationShaderHandle );
     }
     if(mGeometryShaderHandle != 0 ) {
         glDetachShader(mShaderProgramHandle, mGeometryShaderHandle );
-        glDeleteShader(mGeometryShaderHandle );
+        CSCI441::ShaderObjectPool::release(mGeometryShaderHandle );
     }
     if(mFragmentShaderHandle != 0 ) {
         glDetachShader(mShaderProgramHandle, mFragmentShaderHandle );
-        glDeleteShader(mFragmentShaderHandle );
+        CSCI441::ShaderObjectPool::release(mFragmentShaderHandle );
     }
 
     // map uniforms
@@ -1220,6 +1313,10 @@ inline GLint CSCI441::ShaderProgram::getUniformLocation( const char *uniformName
     return uniformLoc;
 }
 
+inline bool CSCI441::ShaderProgram::hasUniform( const char *uniformName ) const {
+    return mpUniformLocationsMap != nullptr && mpUniformLocationsMap->find(uniformName) != mpUniformLocationsMap->end();
+}
+
 inline GLint CSCI441::ShaderProgram::getUniformBlockIndex( const char *uniformBlockName ) const {
     GLint uniformBlockLoc = glGetUniformBlockIndex(mShaderProgramHandle, uniformBlockName );
     if( uniformBlockLoc == -1 )
@@ -1409,6 +1506,7 @@ inline GLuint CSCI441::ShaderProgram::getShaderProgramHandle() const {
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::useProgram() const {
     glUseProgram(mShaderProgramHandle );
+    if( sUseProgramCallback != nullptr ) sUseProgramCallback();
 }
 
 [[maybe_unused]]
@@ -1416,6 +1514,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform1f(mShaderProgramHandle, uniformIter->second, v0 );
+        _countUniformUpload( sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1426,6 +1525,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2f(mShaderProgramHandle, uniformIter->second, v0, v1 );
+        _countUniformUpload( 2 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1441,6 +1541,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3f(mShaderProgramHandle, uniformIter->second, v0, v1, v2 );
+        _countUniformUpload( 3 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1456,6 +1557,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4f(mShaderProgramHandle, uniformIter->second, v0, v1, v2, v3 );
+        _countUniformUpload( 4 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1472,15 +1574,19 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, G
         switch(dim) {
             case 1:
                 glProgramUniform1fv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * sizeof(GLfloat) );
                 break;
             case 2:
                 glProgramUniform2fv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 2 * sizeof(GLfloat) );
                 break;
             case 3:
                 glProgramUniform3fv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 3 * sizeof(GLfloat) );
                 break;
             case 4:
                 glProgramUniform4fv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 4 * sizeof(GLfloat) );
                 break;
             default:
                 fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformName, mShaderProgramHandle);
@@ -1496,6 +1602,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform1i(mShaderProgramHandle, uniformIter->second, v0 );
+        _countUniformUpload( sizeof(GLint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1506,6 +1613,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2i(mShaderProgramHandle, uniformIter->second, v0, v1 );
+        _countUniformUpload( 2 * sizeof(GLint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1516,6 +1624,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2iv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
+        _countUniformUpload( 2 * sizeof(GLint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1526,6 +1635,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3i(mShaderProgramHandle, uniformIter->second, v0, v1, v2 );
+        _countUniformUpload( 3 * sizeof(GLint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1536,6 +1646,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3iv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
+        _countUniformUpload( 3 * sizeof(GLint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1546,6 +1657,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4i(mShaderProgramHandle, uniformIter->second, v0, v1, v2, v3 );
+        _countUniformUpload( 4 * sizeof(GLint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1556,6 +1668,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4iv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
+        _countUniformUpload( 4 * sizeof(GLint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1568,15 +1681,19 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, G
         switch(dim) {
             case 1:
                 glProgramUniform1iv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * sizeof(GLint) );
                 break;
             case 2:
                 glProgramUniform2iv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 2 * sizeof(GLint) );
                 break;
             case 3:
                 glProgramUniform3iv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 3 * sizeof(GLint) );
                 break;
             case 4:
                 glProgramUniform4iv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 4 * sizeof(GLint) );
                 break;
             default:
                 fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformName, mShaderProgramHandle);
@@ -1592,6 +1709,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform1ui(mShaderProgramHandle, uniformIter->second, v0 );
+        _countUniformUpload( sizeof(GLuint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1602,6 +1720,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2ui(mShaderProgramHandle, uniformIter->second, v0, v1 );
+        _countUniformUpload( 2 * sizeof(GLuint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1612,6 +1731,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform2uiv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
+        _countUniformUpload( 2 * sizeof(GLuint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1622,6 +1742,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3ui(mShaderProgramHandle, uniformIter->second, v0, v1, v2 );
+        _countUniformUpload( 3 * sizeof(GLuint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1632,6 +1753,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform3uiv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
+        _countUniformUpload( 3 * sizeof(GLuint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1642,6 +1764,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4ui(mShaderProgramHandle, uniformIter->second, v0, v1, v2, v3 );
+        _countUniformUpload( 4 * sizeof(GLuint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1652,6 +1775,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, g
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniform4uiv(mShaderProgramHandle, uniformIter->second, 1, &value[0] );
+        _countUniformUpload( 4 * sizeof(GLuint) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1664,15 +1788,19 @@ inline void CSCI441::ShaderProgram::setProgramUniform(const char* uniformName, G
         switch(dim) {
             case 1:
                 glProgramUniform1uiv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * sizeof(GLuint) );
                 break;
             case 2:
                 glProgramUniform2uiv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 2 * sizeof(GLuint) );
                 break;
             case 3:
                 glProgramUniform3uiv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 3 * sizeof(GLuint) );
                 break;
             case 4:
                 glProgramUniform4uiv(mShaderProgramHandle, uniformIter->second, count, value );
+                _countUniformUpload( count * 4 * sizeof(GLuint) );
                 break;
             default:
                 fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %s in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformName, mShaderProgramHandle);
@@ -1688,6 +1816,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix2fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 4 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1698,6 +1827,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix3fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 9 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1708,6 +1838,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix4fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 16 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1718,6 +1849,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix2x3fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 6 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1728,6 +1860,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix3x2fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 6 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1738,6 +1871,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix2x4fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 8 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1748,6 +1882,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix4x2fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 8 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1758,6 +1893,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix3x4fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 12 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1768,6 +1904,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
     auto uniformIter = mpUniformLocationsMap->find(uniformName);
     if(uniformIter != mpUniformLocationsMap->end()) {
         glProgramUniformMatrix4x3fv(mShaderProgramHandle, uniformIter->second, 1, GL_FALSE, &mtx[0][0] );
+        _countUniformUpload( 12 * sizeof(GLfloat) );
     } else {
         fprintf(stderr, "[ERROR]: Could not find uniform \"%s\" for Shader Program %u\n", uniformName, mShaderProgramHandle);
     }
@@ -1776,11 +1913,13 @@ inline void CSCI441::ShaderProgram::setProgramUniform( const char *uniformName,
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLfloat v0 ) const {
     glProgramUniform1f(mShaderProgramHandle, uniformLocation, v0 );
+    _countUniformUpload( sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLfloat v0, GLfloat v1 ) const {
     glProgramUniform2f(mShaderProgramHandle, uniformLocation, v0, v1 );
+    _countUniformUpload( 2 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
@@ -1791,6 +1930,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, gl
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLfloat v0, GLfloat v1, GLfloat v2 ) const {
     glProgramUniform3f(mShaderProgramHandle, uniformLocation, v0, v1, v2 );
+    _countUniformUpload( 3 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
@@ -1801,6 +1941,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, gl
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3 ) const {
     glProgramUniform4f(mShaderProgramHandle, uniformLocation, v0, v1, v2, v3 );
+    _countUniformUpload( 4 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
@@ -1812,15 +1953,19 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
     switch(dim) {
         case 1:
             glProgramUniform1fv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * sizeof(GLfloat) );
             break;
         case 2:
             glProgramUniform2fv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 2 * sizeof(GLfloat) );
             break;
         case 3:
             glProgramUniform3fv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 3 * sizeof(GLfloat) );
             break;
         case 4:
             glProgramUniform4fv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 4 * sizeof(GLfloat) );
             break;
         default:
             fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformLocation, mShaderProgramHandle);
@@ -1831,11 +1976,13 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLint v0 ) const {
     glProgramUniform1i(mShaderProgramHandle, uniformLocation, v0 );
+    _countUniformUpload( sizeof(GLint) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLint v0, GLint v1 ) const {
     glProgramUniform2i(mShaderProgramHandle, uniformLocation, v0, v1 );
+    _countUniformUpload( 2 * sizeof(GLint) );
 }
 
 [[maybe_unused]]
@@ -1846,6 +1993,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, glm
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLint v0, GLint v1, GLint v2 ) const {
     glProgramUniform3i(mShaderProgramHandle, uniformLocation, v0, v1, v2 );
+    _countUniformUpload( 3 * sizeof(GLint) );
 }
 
 [[maybe_unused]]
@@ -1856,6 +2004,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, glm
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLint v0, GLint v1, GLint v2, GLint v3 ) const {
     glProgramUniform4i(mShaderProgramHandle, uniformLocation, v0, v1, v2, v3 );
+    _countUniformUpload( 4 * sizeof(GLint) );
 }
 
 [[maybe_unused]]
@@ -1867,15 +2016,19 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
     switch(dim) {
         case 1:
             glProgramUniform1iv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * sizeof(GLint) );
             break;
         case 2:
             glProgramUniform2iv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 2 * sizeof(GLint) );
             break;
         case 3:
             glProgramUniform3iv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 3 * sizeof(GLint) );
             break;
         case 4:
             glProgramUniform4iv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 4 * sizeof(GLint) );
             break;
         default:
             fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformLocation, mShaderProgramHandle);
@@ -1886,11 +2039,13 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLuint v0 ) const {
     glProgramUniform1ui(mShaderProgramHandle, uniformLocation, v0 );
+    _countUniformUpload( sizeof(GLuint) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLuint v0, GLuint v1 ) const {
     glProgramUniform2ui(mShaderProgramHandle, uniformLocation, v0, v1 );
+    _countUniformUpload( 2 * sizeof(GLuint) );
 }
 
 [[maybe_unused]]
@@ -1901,6 +2056,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, glm
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLuint v0, GLuint v1, GLuint v2 ) const {
     glProgramUniform3ui(mShaderProgramHandle, uniformLocation, v0, v1, v2 );
+    _countUniformUpload( 3 * sizeof(GLuint) );
 }
 
 [[maybe_unused]]
@@ -1911,6 +2067,7 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, glm
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, GLuint v0, GLuint v1, GLuint v2, GLuint v3 ) const {
     glProgramUniform4ui(mShaderProgramHandle, uniformLocation, v0, v1, v2, v3 );
+    _countUniformUpload( 4 * sizeof(GLuint) );
 }
 
 [[maybe_unused]]
@@ -1922,15 +2079,19 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
     switch(dim) {
         case 1:
             glProgramUniform1uiv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * sizeof(GLuint) );
             break;
         case 2:
             glProgramUniform2uiv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 2 * sizeof(GLuint) );
             break;
         case 3:
             glProgramUniform3uiv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 3 * sizeof(GLuint) );
             break;
         case 4:
             glProgramUniform4uiv(mShaderProgramHandle, uniformLocation, count, value );
+            _countUniformUpload( count * 4 * sizeof(GLuint) );
             break;
         default:
             fprintf(stderr, "[ERROR]: invalid dimension %u for uniform %i in Shader Program %u.  Dimension must be [1,4]\n", dim, uniformLocation, mShaderProgramHandle);
@@ -1941,46 +2102,55 @@ inline void CSCI441::ShaderProgram::setProgramUniform(GLint uniformLocation, GLu
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat2 mtx ) const {
     glProgramUniformMatrix2fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 4 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat3 mtx ) const {
     glProgramUniformMatrix3fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 9 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat4 mtx ) const {
     glProgramUniformMatrix4fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 16 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat2x3 mtx ) const {
     glProgramUniformMatrix2x3fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 6 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat3x2 mtx ) const {
     glProgramUniformMatrix3x2fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 6 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat2x4 mtx ) const {
     glProgramUniformMatrix2x4fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 8 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat4x2 mtx ) const {
     glProgramUniformMatrix4x2fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 8 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat3x4 mtx ) const {
     glProgramUniformMatrix3x4fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 12 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
 inline void CSCI441::ShaderProgram::setProgramUniform( GLint uniformLocation, glm::mat4x3 mtx ) const {
     glProgramUniformMatrix4x3fv(mShaderProgramHandle, uniformLocation, 1, GL_FALSE, &mtx[0][0] );
+    _countUniformUpload( 12 * sizeof(GLfloat) );
 }
 
 [[maybe_unused]]
@@ -2007,6 +2177,7 @@ inline void CSCI441::ShaderProgram::_initialize() {
     mShaderProgramHandle = 0;
     mpUniformLocationsMap = nullptr;
     mpAttributeLocationsMap = nullptr;
+    mDefines.clear();
 }
 
 inline CSCI441::ShaderProgram::~ShaderProgram() {
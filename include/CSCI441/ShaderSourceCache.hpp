@@ -0,0 +1,392 @@
+/**
+ * @file ShaderSourceCache.hpp
+ * @brief Loads, preprocesses and caches shader sources without copying them
+ * @author Taylor Rodgers
+ *
+ * @copyright MIT License Copyright (c) 2026 Taylor Rodgers
+ *
+ * Shader files are memory mapped and a preprocessed source is a list of
+ * pointers into the mapped files, handed to glShaderSource as is.
+ *
+ * @warning NOTE: This header file depends upon GLEW
+ */
+
+#ifndef CSCI441_SHADER_SOURCE_CACHE_HPP
+#define CSCI441_SHADER_SOURCE_CACHE_HPP
+
+#include "trace.hpp"
+
+#include <GL/glew.h>
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//********************************************************************************************************************
+
+namespace CSCI441_INTERNAL {
+    /**
+     * @brief read only view of a whole file, memory mapped where the platform allows
+     */
+    class MappedFile {
+    public:
+        /**
+         * @brief maps a file
+         * @param path file to map
+         * @returns the mapped file, nullptr if it could not be opened
+         */
+        static std::shared_ptr<const MappedFile> open(const std::string& path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief path the file was opened with
+         */
+        [[nodiscard]] const std::string& getPath() const noexcept { return mPath; }
+        /**
+         * @brief contents of the file, not null terminated
+         */
+        [[nodiscard]] const char* getData() const noexcept { return mpData; }
+        /**
+         * @brief size of the file in bytes
+         */
+        [[nodiscard]] size_t getSize() const noexcept { return mSize; }
+        /**
+         * @brief true if the file on disk has been written or removed since it was mapped
+         */
+        [[nodiscard]] bool isStale() const;
+
+    private:
+        MappedFile() : mpData(nullptr), mSize(0), mIsMapped(false) {}
+
+        std::string mPath;
+        std::filesystem::file_time_type mModifiedTime;
+        const char* mpData;
+        size_t mSize;
+        bool mIsMapped;
+        // holds the contents where the file could not be mapped
+        std::string mBuffer;
+    };
+}
+
+namespace CSCI441 {
+
+    /**
+     * @class ShaderSource
+     * @brief a preprocessed shader source, ready to hand to glShaderSource without copying
+     * @note the strings point into the memory mapped files the source was read from, so a
+     * file must be replaced rather than truncated in place while a source using it is alive
+     */
+    class ShaderSource {
+    public:
+        /**
+         * @brief number of strings making up the source
+         */
+        [[nodiscard]] GLsizei getNumStrings() const noexcept { return (GLsizei)mStrings.size(); }
+        /**
+         * @brief strings making up the source, not null terminated
+         */
+        [[nodiscard]] const GLchar* const* getStrings() const noexcept { return mStrings.data(); }
+        /**
+         * @brief length of each string
+         */
+        [[nodiscard]] const GLint* getLengths() const noexcept { return mLengths.data(); }
+        /**
+         * @brief every file the source was read from, the requested file first and then its includes
+         * @note #line directives name the files by their index in this list
+         */
+        [[nodiscard]] std::vector<std::string> getFiles() const;
+        /**
+         * @brief true if any file the source was read from has changed since
+         */
+        [[nodiscard]] bool isStale() const;
+        /**
+         * @brief sends the source to a shader object
+         * @param shaderHandle shader object to set the source of
+         */
+        void setShaderSource(GLuint shaderHandle) const;
+
+    private:
+        friend class ShaderSourceCache;
+
+        std::vector<const GLchar*> mStrings;
+        std::vector<GLint> mLengths;
+        // strings made up by the preprocessor, a deque so they never move
+        std::deque<std::string> mGeneratedStrings;
+        // keeps the files the strings point into mapped
+        std::vector<std::shared_ptr<const CSCI441_INTERNAL::MappedFile>> mFiles;
+
+        void _addString(const char* string, size_t length);
+        void _addGeneratedString(std::string string);
+    };
+
+    /**
+     * @class ShaderSourceCache
+     * @brief loads shader sources, resolving #include and injecting #define, and keeps them
+     * by path, defines and the modified time of every file they were read from
+     * @note \#include "file" is resolved relative to the including file and each file is only
+     * included once per source, so includes need no guards of their own.  safe to use from
+     * any thread.
+     */
+    class ShaderSourceCache final {
+    public:
+        /**
+         * @brief loads a shader source, from the cache if none of its files have changed
+         * @param filename shader file to load
+         * @param defines macros to define after the #version line, each as "NAME" or "NAME VALUE"
+         * @returns the preprocessed source, nullptr if a file could not be read
+         */
+        static std::shared_ptr<const ShaderSource> load(const char* filename, const std::vector<std::string>& defines = {});
+        /**
+         * @brief forgets every cached file and source, sources still in use stay valid
+         */
+        [[maybe_unused]] static void clear();
+
+    private:
+        static std::mutex sMutex;
+        static std::map<std::string, std::shared_ptr<const CSCI441_INTERNAL::MappedFile>> sFiles;
+        static std::map<std::string, std::shared_ptr<const ShaderSource>> sSources;
+
+        static std::shared_ptr<const CSCI441_INTERNAL::MappedFile> _openFile(const std::string& path);
+        static bool _preprocess(ShaderSource& source, const std::string& path, const std::string& defineBlock,
+                                bool isRoot, std::vector<std::string>& includedFiles);
+    };
+}
+
+//********************************************************************************************************************
+
+inline std::shared_ptr<const CSCI441_INTERNAL::MappedFile> CSCI441_INTERNAL::MappedFile::open(const std::string& path) {
+    std::error_code error;
+    const std::filesystem::file_time_type modifiedTime = std::filesystem::last_write_time(path, error);
+    if( error ) return nullptr;
+
+    std::shared_ptr<MappedFile> pFile(new MappedFile());
+    pFile->mPath = path;
+    pFile->mModifiedTime = modifiedTime;
+
+#ifndef _WIN32
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if( fd < 0 ) return nullptr;
+    struct stat fileStat{};
+    if( fstat(fd, &fileStat) != 0 ) {
+        close(fd);
+        return nullptr;
+    }
+    pFile->mSize = (size_t)fileStat.st_size;
+    if( pFile->mSize > 0 ) {
+        void* pMapping = mmap(nullptr, pFile->mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if( pMapping != MAP_FAILED ) {
+            pFile->mpData = (const char*)pMapping;
+            pFile->mIsMapped = true;
+        }
+    }
+    close(fd);
+    if( pFile->mSize > 0 && !pFile->mIsMapped ) return nullptr;
+#else
+    std::ifstream in(path, std::ios::binary);
+    if( !in.is_open() ) return nullptr;
+    pFile->mBuffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    pFile->mpData = pFile->mBuffer.data();
+    pFile->mSize = pFile->mBuffer.size();
+#endif
+
+    return pFile;
+}
+
+inline CSCI441_INTERNAL::MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if( mIsMapped ) munmap((void*)mpData, mSize);
+#endif
+}
+
+inline bool CSCI441_INTERNAL::MappedFile::isStale() const {
+    std::error_code error;
+    const std::filesystem::file_time_type modifiedTime = std::filesystem::last_write_time(mPath, error);
+    return error || modifiedTime != mModifiedTime;
+}
+
+//********************************************************************************************************************
+
+inline std::vector<std::string> CSCI441::ShaderSource::getFiles() const {
+    std::vector<std::string> files;
+    files.reserve(mFiles.size());
+    for(const auto& pFile : mFiles) files.push_back(pFile->getPath());
+    return files;
+}
+
+inline bool CSCI441::ShaderSource::isStale() const {
+    for(const auto& pFile : mFiles) {
+        if( pFile->isStale() ) return true;
+    }
+    return false;
+}
+
+inline void CSCI441::ShaderSource::setShaderSource(const GLuint shaderHandle) const {
+    glShaderSource(shaderHandle, getNumStrings(), getStrings(), getLengths());
+}
+
+inline void CSCI441::ShaderSource::_addString(const char* string, const size_t length) {
+    if( length == 0 ) return;
+    mStrings.push_back(string);
+    mLengths.push_back((GLint)length);
+}
+
+inline void CSCI441::ShaderSource::_addGeneratedString(std::string string) {
+    mGeneratedStrings.push_back(std::move(string));
+    _addString(mGeneratedStrings.back().c_str(), mGeneratedStrings.back().length());
+}
+
+//********************************************************************************************************************
+
+inline std::mutex CSCI441::ShaderSourceCache::sMutex;
+inline std::map<std::string, std::shared_ptr<const CSCI441_INTERNAL::MappedFile>> CSCI441::ShaderSourceCache::sFiles;
+inline std::map<std::string, std::shared_ptr<const CSCI441::ShaderSource>> CSCI441::ShaderSourceCache::sSources;
+
+inline std::shared_ptr<const CSCI441::ShaderSource> CSCI441::ShaderSourceCache::load(
+        const char* filename,
+        const std::vector<std::string>& defines
+) {
+    CSCI441_TRACE_SCOPE("ShaderSourceCache::load");
+
+    std::string defineBlock;
+    for(const std::string& define : defines) {
+        defineBlock += "#define " + define + "\n";
+    }
+    const std::string path = std::filesystem::path(filename).lexically_normal().generic_string();
+    const std::string key = path + '\n' + defineBlock;
+
+    std::lock_guard<std::mutex> lock(sMutex);
+
+    auto sourceIter = sSources.find(key);
+    if( sourceIter != sSources.end() && !sourceIter->second->isStale() ) {
+        return sourceIter->second;
+    }
+
+    auto pSource = std::make_shared<ShaderSource>();
+    std::vector<std::string> includedFiles;
+    if( !_preprocess(*pSource, path, defineBlock, true, includedFiles) ) {
+        return nullptr;
+    }
+    sSources[key] = pSource;
+    return pSource;
+}
+
+inline void CSCI441::ShaderSourceCache::clear() {
+    std::lock_guard<std::mutex> lock(sMutex);
+    sSources.clear();
+    sFiles.clear();
+}
+
+inline std::shared_ptr<const CSCI441_INTERNAL::MappedFile> CSCI441::ShaderSourceCache::_openFile(const std::string& path) {
+    auto fileIter = sFiles.find(path);
+    if( fileIter != sFiles.end() && !fileIter->second->isStale() ) {
+        return fileIter->second;
+    }
+
+    auto pFile = CSCI441_INTERNAL::MappedFile::open(path);
+    if( pFile == nullptr ) {
+        sFiles.erase(path);
+        return nullptr;
+    }
+    sFiles[path] = pFile;
+    return pFile;
+}
+
+inline bool CSCI441::ShaderSourceCache::_preprocess(
+        ShaderSource& source,
+        const std::string& path,
+        const std::string& defineBlock,
+        const bool isRoot,
+        std::vector<std::string>& includedFiles
+) {
+    const auto pFile = _openFile(path);
+    if( pFile == nullptr ) {
+        fprintf( stderr, "[ERROR]: Could not open file %s\n", path.c_str() );
+        return false;
+    }
+    const size_t fileIndex = source.mFiles.size();
+    source.mFiles.push_back(pFile);
+    includedFiles.push_back(path);
+    if( !isRoot ) source._addGeneratedString("#line 1 " + std::to_string(fileIndex) + "\n");
+
+    // the defines go straight after #version, or first of all if there is none
+    const size_t firstStringIndex = source.mStrings.size();
+    bool hasInjectedDefines = !isRoot || defineBlock.empty();
+
+    const char* const pBegin = pFile->getData();
+    const char* const pEnd = pBegin + pFile->getSize();
+    const char* pSegmentStart = pBegin;
+    size_t lineNumber = 1;
+    for(const char* pLine = pBegin; pLine < pEnd; lineNumber++) {
+        const char* pLineEnd = (const char*)memchr(pLine, '\n', (size_t)(pEnd - pLine));
+        if( pLineEnd == nullptr ) pLineEnd = pEnd;
+        const char* pNextLine = pLineEnd < pEnd ? pLineEnd + 1 : pEnd;
+
+        const char* pChar = pLine;
+        while( pChar < pLineEnd && (*pChar == ' ' || *pChar == '\t') ) pChar++;
+        if( pChar < pLineEnd && *pChar == '#' ) {
+            pChar++;
+            while( pChar < pLineEnd && (*pChar == ' ' || *pChar == '\t') ) pChar++;
+            const size_t directiveLength = (size_t)(pLineEnd - pChar);
+
+            if( !hasInjectedDefines && directiveLength >= 7 && strncmp(pChar, "version", 7) == 0 ) {
+                source._addString(pSegmentStart, (size_t)(pNextLine - pSegmentStart));
+                source._addGeneratedString(defineBlock + "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n");
+                hasInjectedDefines = true;
+                pSegmentStart = pNextLine;
+            } else if( directiveLength >= 7 && strncmp(pChar, "include", 7) == 0 ) {
+                const char* pNameStart = pChar + 7;
+                while( pNameStart < pLineEnd && *pNameStart != '"' && *pNameStart != '<' ) pNameStart++;
+                const char closingQuote = pNameStart < pLineEnd && *pNameStart == '<' ? '>' : '"';
+                const char* pNameEnd = pNameStart < pLineEnd ? (const char*)memchr(pNameStart + 1, closingQuote, (size_t)(pLineEnd - pNameStart - 1)) : nullptr;
+                if( pNameEnd == nullptr ) {
+                    fprintf( stderr, "[ERROR]: Malformed #include on line %zu of %s\n", lineNumber, path.c_str() );
+                    return false;
+                }
+
+                source._addString(pSegmentStart, (size_t)(pLine - pSegmentStart));
+                const std::string includePath = (std::filesystem::path(path).parent_path() / std::string(pNameStart + 1, pNameEnd))
+                        .lexically_normal().generic_string();
+                bool isIncluded = false;
+                for(const std::string& includedFile : includedFiles) {
+                    if( includedFile == includePath ) { isIncluded = true; break; }
+                }
+                if( !isIncluded && !_preprocess(source, includePath, defineBlock, false, includedFiles) ) {
+                    return false;
+                }
+                // the directive's line is gone, so the numbering picks up again on the line after it
+                source._addGeneratedString("#line " + std::to_string(lineNumber + 1) + " " + std::to_string(fileIndex) + "\n");
+                pSegmentStart = pNextLine;
+            }
+        }
+        pLine = pNextLine;
+    }
+    source._addString(pSegmentStart, (size_t)(pEnd - pSegmentStart));
+    // the #line after an include has to start a line of its own
+    if( !isRoot && pEnd > pBegin && pEnd[-1] != '\n' ) source._addGeneratedString("\n");
+
+    if( !hasInjectedDefines ) {
+        source.mGeneratedStrings.push_back(defineBlock + "#line 1 " + std::to_string(fileIndex) + "\n");
+        source.mStrings.insert(source.mStrings.begin() + (std::ptrdiff_t)firstStringIndex, source.mGeneratedStrings.back().c_str());
+        source.mLengths.insert(source.mLengths.begin() + (std::ptrdiff_t)firstStringIndex, (GLint)source.mGeneratedStrings.back().length());
+    }
+    return true;
+}
+
+#endif // CSCI441_SHADER_SOURCE_CACHE_HPP
@@ -20,6 +20,10 @@
 #include <cstring>
 #include <fstream>
 #include <string>
+#include <vector>
+
+#include "ShaderSourceCache.hpp"
+#include "trace.hpp"
 
 //********************************************************************************************************************
 
@@ -53,11 +57,18 @@ namespace CSCI441_INTERNAL::ShaderUtils {
     // bool true if file was successfully opened and read.  false otherwise
     bool readTextFromFile( const char* filename, char* &output );
 
-    // Reads the contents of a text file and compiles the associated shader type
+    // Loads a shader file through the shader source cache and compiles the associated shader type
     // const char* filename of shader file to read in
     // GLenum type of shader file corresponds to
+    // std::vector<std::string> macros to define after the #version line, each as "NAME" or "NAME VALUE"
     // GLuint shader handle if compilation successful.  -1 otherwise
-    GLuint compileShader( const char *filename, GLenum shaderType );
+    GLuint compileShader( const char *filename, GLenum shaderType, const std::vector<std::string>& defines = {} );
+
+    // Compiles an already preprocessed source as the associated shader type
+    // CSCI441::ShaderSource source to send to the GPU
+    // GLenum type of shader the source corresponds to
+    // GLuint shader handle, the compile status tells whether compilation was successful
+    GLuint compileShader( const CSCI441::ShaderSource& shaderSource, GLenum shaderType );
 
     // Prints the shader log for the associated Shader handle
     void printShaderLog( GLuint shaderHandle );
@@ -110,24 +121,23 @@ inline bool CSCI441_INTERNAL::ShaderUtils::readTextFromFile(
         const char *filename,
         char* &output
 ){
-    std::string buf = std::string("");
-    std::string line;
+    CSCI441_TRACE_SCOPE("ShaderUtils::readTextFromFile");
 
-    std::ifstream in(filename);
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
     if( !in.is_open() ) {
     	fprintf( stderr, "[ERROR]: Could not open file %s\n", filename );
     	return false;
     }
-    while( std::getline(in, line) ) {
-        buf += line + "\n";
-    }
-	
-	output = new char[buf.length()+1];
-	strncpy(output, buf.c_str(), buf.length());
-	output[buf.length()] = '\0';
-	
+
+    // read the whole file in one go straight into the output
+    const std::streamsize length = in.tellg();
+    in.seekg(0, std::ios::beg);
+	output = new char[length+1];
+	in.read(output, length);
+	output[in.gcount()] = '\0';
+
     in.close();
-	
+
 	return true;
 }
 
@@ -794,30 +804,37 @@ inline void CSCI441_INTERNAL::ShaderUtils::printShaderProgramInfo(
 
 inline GLuint CSCI441_INTERNAL::ShaderUtils::compileShader(
         const char *filename,
-        const GLenum shaderType
+        const GLenum shaderType,
+        const std::vector<std::string>& defines
 ) {
-	GLuint shaderHandle = glCreateShader( shaderType );	char *shaderString;
+    CSCI441_TRACE_SCOPE("ShaderUtils::compileShader");
 
-    // read in each text file and store the contents in a string
-    if( readTextFromFile( filename, shaderString ) ) {
+    // mapped, preprocessed and cached, nothing is read again unless the file changed
+    const auto pShaderSource = CSCI441::ShaderSourceCache::load( filename, defines );
+    if( pShaderSource != nullptr ) {
+		return compileShader( *pShaderSource, shaderType );
+	} else {
+		return -1;
+	}
+}
 
-		// send the contents of each program to the GPU
-		glShaderSource( shaderHandle, 1, (const char**)&shaderString, nullptr );
+inline GLuint CSCI441_INTERNAL::ShaderUtils::compileShader(
+        const CSCI441::ShaderSource& shaderSource,
+        const GLenum shaderType
+) {
+    GLuint shaderHandle = glCreateShader( shaderType );
 
-		// we are good programmers so free up the memory used by each buffer
-		delete [] shaderString;
+    // send the pieces of the source to the GPU straight from the mapped files
+    shaderSource.setShaderSource( shaderHandle );
 
-		// compile each shader on the GPU
-		glCompileShader( shaderHandle );
+    // compile each shader on the GPU
+    glCompileShader( shaderHandle );
 
-		// check the shader log
-		printShaderLog( shaderHandle );
+    // check the shader log
+    printShaderLog( shaderHandle );
 
-		// return the handle of our shader
-		return shaderHandle;
-	} else {
-		return -1;
-	}
+    // return the handle of our shader
+    return shaderHandle;
 }
 
 #endif // CSCI441_SHADER_UTILS_HPP
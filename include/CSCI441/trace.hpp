@@ -0,0 +1,28 @@
+/**
+ * @file trace.hpp
+ * @brief Hook for timing the library's hot paths in an application's profiler
+ * @author Taylor Rodgers
+ *
+ * @copyright MIT License Copyright (c) 2026 Taylor Rodgers
+ *
+ * Define CSCI441_TRACE_HEADER as the path of a header that defines
+ * CSCI441_TRACE_SCOPE to route the library's timings into a profiler.
+ */
+
+#ifndef CSCI441_TRACE_HPP
+#define CSCI441_TRACE_HPP
+
+#ifdef CSCI441_TRACE_HEADER
+#include CSCI441_TRACE_HEADER
+#endif
+
+#ifndef CSCI441_TRACE_SCOPE
+/**
+ * @brief times the rest of the enclosing block under the given name
+ * @note compiles to nothing unless the application defines it, either directly or in the
+ * header named by CSCI441_TRACE_HEADER, to hook the library's hot paths into its profiler
+ */
+#define CSCI441_TRACE_SCOPE(name) ((void)0)
+#endif
+
+#endif // CSCI441_TRACE_HPP
@@ -16,12 +16,99 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
 ///*****************************************************************************
 //
 // Our main function
-int main() {
+int main(int argc, char* argv[]) {
+
+    // parse any command line options
+    A3Engine::Settings settings;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "--frames-in-flight") == 0 && i + 1 < argc) {
+            settings.framesInFlight = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--worker-threads") == 0 && i + 1 < argc) {
+            settings.workerThreads = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--simulation-rate") == 0 && i + 1 < argc) {
+            const GLdouble simulationRate = strtod(argv[++i], nullptr);
+            if(std::isfinite(simulationRate) && simulationRate > 0.0) {
+                settings.simulationRate = simulationRate;
+            } else {
+                fprintf(stderr, "[ERROR]: Invalid simulation rate \"%s\", expected a positive number of steps per second, using %g\n", argv[i], settings.simulationRate);
+            }
+        } else if(strcmp(argv[i], "--time-scale") == 0 && i + 1 < argc) {
+            const GLdouble timeScale = strtod(argv[++i], nullptr);
+            if(std::isfinite(timeScale) && timeScale > 0.0) {
+                settings.timeScale = timeScale;
+            } else {
+                fprintf(stderr, "[ERROR]: Invalid time scale \"%s\", expected a positive number, using %g\n", argv[i], settings.timeScale);
+            }
+        } else if(strcmp(argv[i], "--simulation-only") == 0) {
+            settings.simulationOnly = true;
+        } else if(strcmp(argv[i], "--late-latch") == 0) {
+            settings.lateLatchCamera = true;
+        } else if(strcmp(argv[i], "--raw-mouse") == 0) {
+            settings.rawMouseMotion = true;
+        } else if(strcmp(argv[i], "--reverse-z") == 0) {
+            settings.reverseZ = true;
+        } else if(strcmp(argv[i], "--idle") == 0) {
+            settings.idleMode = true;
+        } else if(strcmp(argv[i], "--idle-rate") == 0 && i + 1 < argc) {
+            settings.idleAnimationRate = strtod(argv[++i], nullptr);
+        } else if(strcmp(argv[i], "--headless") == 0) {
+            settings.headless = true;
+        } else if(strcmp(argv[i], "--benchmark-frames") == 0 && i + 1 < argc) {
+            settings.benchmarkFrames = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--benchmark-output") == 0 && i + 1 < argc) {
+            settings.benchmarkOutput = argv[++i];
+        } else if(strcmp(argv[i], "--benchmark-script") == 0 && i + 1 < argc) {
+            settings.benchmarkScript = argv[++i];
+        } else if(strcmp(argv[i], "--record-input") == 0 && i + 1 < argc) {
+            settings.recordInput = argv[++i];
+        } else if(strcmp(argv[i], "--replay-input") == 0 && i + 1 < argc) {
+            settings.replayInput = argv[++i];
+        } else if(strcmp(argv[i], "--world-seed") == 0 && i + 1 < argc) {
+            settings.worldSeed = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            settings.profileOutput = argv[++i];
+        } else if(strcmp(argv[i], "--gpu-profile") == 0) {
+            settings.gpuProfile = true;
+        } else if(strcmp(argv[i], "--stats-overlay") == 0) {
+            settings.statsOverlay = true;
+        } else if(strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            settings.telemetryOutput = argv[++i];
+        } else if(strcmp(argv[i], "--telemetry-interval") == 0 && i + 1 < argc) {
+            settings.telemetryInterval = strtod(argv[++i], nullptr);
+        } else if(strcmp(argv[i], "--hot-reload") == 0) {
+            settings.shaderHotReload = true;
+        } else if(strcmp(argv[i], "--stress-tiles") == 0 && i + 1 < argc) {
+            settings.stress.numTiles = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--stress-heroes") == 0 && i + 1 < argc) {
+            settings.stress.numHeroes = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--stress-lights") == 0 && i + 1 < argc) {
+            settings.stress.numLights = (GLuint)strtoul(argv[++i], nullptr, 10);
+        } else if(strcmp(argv[i], "--stress-density") == 0 && i + 1 < argc) {
+            settings.stress.density = (GLfloat)strtod(argv[++i], nullptr);
+        } else if(strcmp(argv[i], "--stress-max-height") == 0 && i + 1 < argc) {
+            settings.stress.maxTileHeight = (GLfloat)strtod(argv[++i], nullptr);
+        } else if(strcmp(argv[i], "--stress-distribution") == 0 && i + 1 < argc) {
+            i++;
+            if(strcmp(argv[i], "clustered") == 0) {
+                settings.stress.distribution = A3Engine::Settings::StressScene::Distribution::CLUSTERED;
+            } else if(strcmp(argv[i], "uniform") == 0) {
+                settings.stress.distribution = A3Engine::Settings::StressScene::Distribution::UNIFORM;
+            } else {
+                fprintf(stderr, "[WARN]: Unknown stress distribution \"%s\", expected uniform or clustered\n", argv[i]);
+            }
+        } else {
+            fprintf(stderr, "[WARN]: Unknown option %s\n", argv[i]);
+        }
+    }
 
-    auto labEngine = new A3Engine();
+    auto labEngine = new A3Engine(settings);
     labEngine->initialize();
     if (labEngine->getError() == CSCI441::OpenGLEngine::OPENGL_ENGINE_ERROR_NO_ERROR) {
         labEngine->run();
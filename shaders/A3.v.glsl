@@ -11,6 +11,17 @@ uniform vec3 lightColor;
 
 uniform vec3 materialColor;             // the material color for our vertex (& whole object)
 
+#ifdef POINT_LIGHTS
+uniform mat4 modelMatrix;               // the model matrix, places the vertex relative to the point lights
+
+// point lights added by a stress scene, MAX_POINT_LIGHTS must match A3Engine
+const int MAX_POINT_LIGHTS = 64;
+const float POINT_LIGHT_RANGE = 10.0;   // distance over which a point light fades out
+uniform int numPointLights;
+uniform vec3 pointLightPositions[MAX_POINT_LIGHTS];
+uniform vec3 pointLightColors[MAX_POINT_LIGHTS];
+#endif
+
 // attribute inputs
 layout(location = 0) in vec3 vPos;      // the position of this specific vertex in object space
 // TODO #C: add vertex normal
@@ -33,6 +44,16 @@ void main() {
     float diffuseFactor = max(dot(worldSpaceNormal, lightVec), 0.0);
     vec3 diffuseColor = lightColor * materialColor * diffuseFactor;
 
+#ifdef POINT_LIGHTS
+    // add each point light, fading out linearly with distance
+    vec3 worldSpacePosition = vec3(modelMatrix * vec4(vPos, 1.0));
+    for(int i = 0; i < numPointLights; i++) {
+        vec3 toLight = pointLightPositions[i] - worldSpacePosition;
+        float attenuation = clamp(1.0 - length(toLight) / POINT_LIGHT_RANGE, 0.0, 1.0);
+        diffuseColor += pointLightColors[i] * materialColor * max(dot(worldSpaceNormal, normalize(toLight)), 0.0) * attenuation;
+    }
+#endif
+
     // TODO #G: assign the color for this vertex
     color = diffuseColor;
 }
\ No newline at end of file
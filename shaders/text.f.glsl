@@ -0,0 +1,17 @@
+#version 410 core
+
+// uniform inputs
+uniform sampler2D fontTexture;          // every glyph side by side, set where the glyph covers the pixel
+uniform vec3 textColor;                 // color to draw the text in
+
+// varying inputs
+in vec2 texCoord;                       // texture coordinate to look the font up at
+
+// outputs
+out vec4 fragColorOut;                  // color to apply to this fragment
+
+void main() {
+    // the font is either on or off, leave uncovered pixels untouched
+    if(texture(fontTexture, texCoord).r < 0.5) discard;
+    fragColorOut = vec4(textColor, 1.0);
+}
@@ -0,0 +1,19 @@
+#version 410 core
+
+// uniform inputs
+uniform vec2 viewportSize;              // size of the viewport in pixels
+
+// attribute inputs
+in vec2 vPos;                           // position of the glyph corner in pixels from the top left corner
+in vec2 vTexCoord;                      // texture coordinate of the glyph corner in the font texture
+
+// varying outputs
+out vec2 texCoord;                      // texture coordinate to look the font up at
+
+void main() {
+    // pixels from the top left to normalized device coordinates
+    vec2 ndc = vec2(vPos.x / viewportSize.x * 2.0 - 1.0, 1.0 - vPos.y / viewportSize.y * 2.0);
+    gl_Position = vec4(ndc, 0.0, 1.0);
+
+    texCoord = vTexCoord;
+}